@@ -101,3 +101,11 @@ endif()
 if (CONFIG_AT_USER_COMMAND_SUPPORT)
     target_link_libraries(${COMPONENT_LIB} INTERFACE "-u esp_at_user_cmd_regist")
 endif()
+
+if (CONFIG_AT_BOOT_PROFILE_SUPPORT)
+    target_link_libraries(${COMPONENT_LIB} INTERFACE "-u esp_at_boot_prof_cmd_regist")
+endif()
+
+if (CONFIG_AT_SYSMON_COMMAND_SUPPORT)
+    target_link_libraries(${COMPONENT_LIB} INTERFACE "-u esp_at_sysmon_cmd_regist")
+endif()
@@ -13,6 +13,7 @@
 
 #define ESP_AT_PORT_TX_WAIT_MS_MAX          3000    // 3s
 #define AT_BUFFER_ON_STACK_SIZE             128     // default maximum buffer size on task stack
+#define ESP_AT_PARA_NUM_MAX                 16      // maximum number of parameters the AT core parses in one command
 
 /**
  * @brief Same to ESP_LOG_BUFFER_HEXDUMP, but only output when buffer is not NULL
@@ -30,6 +31,80 @@ typedef enum {
     AT_PARAMS_IN_PARTITION = 2,
 } at_mfg_params_storage_mode_t;
 
+#define AT_MFG_MODULE_NAME_MAX_LEN          32
+
+/**
+ * @brief module information, the module_name should be the same as the module_name in the factory parameters
+ */
+typedef struct {
+    const char *module_name;
+    const char *ota_token;          /*!< NULL if OTA is not used */
+    const char *ota_ssl_token;      /*!< NULL if OTA is not used */
+} at_module_info_t;
+
+// Forces data into an at_module_info section
+#define AT_MODULE_INFO_ATTR(tag)  __attribute__((used)) _SECTION_ATTR_IMPL(".at_module_info", tag)
+
+/**
+ * @brief Define an additional module outside at_default_config.c
+ *
+ * The module gets an id after all the built-in modules of the current target, in the alphabetical order of the tag.
+ *
+ * @param tag: an unique identifier of the module
+ * @param name: module name string, as the module_name in the factory parameters
+ * @param token: OTA token, or NULL
+ * @param ssl_token: OTA SSL token, or NULL
+ */
+#define ESP_AT_MODULE_INFO_DEFINE(tag, name, token, ssl_token)        \
+    static AT_MODULE_INFO_ATTR(tag) at_module_info_t s_at_module_info_##tag = {.module_name = (name), .ota_token = (token), .ota_ssl_token = (ssl_token)}
+
+/**
+ * @brief system tuning parameters from the "sys_tune" namespace of the manufacturing nvs
+ *
+ * @note A zero value means the parameter is not set, and the compile-time default is used.
+ *       The values are clamped to sane bounds by their getters.
+ */
+typedef struct {
+    uint32_t process_task_stack_size;   /*!< key "proc_stack" */
+    uint32_t socket_task_stack_size;    /*!< key "sock_stack" */
+    uint32_t netconn_max_count;         /*!< key "netconn_max", no more than CONFIG_AT_SOCKET_MAX_CONN_NUM */
+    uint32_t http_tx_buffer_size;       /*!< key "http_tx_buf" */
+    uint32_t http_rx_buffer_size;       /*!< key "http_rx_buf" */
+    uint32_t intf_task_stack_size;      /*!< key "intf_stack", the task of the AT interface (uart/spi/sdio/socket) */
+    uint8_t intf_task_priority;         /*!< key "intf_prio" */
+    int8_t intf_task_core_id;           /*!< key "intf_core", -1 if not set */
+} at_sys_tune_t;
+
+/**
+ * @brief factory parameters decoded once from the manufacturing nvs or the legacy factory_param partition
+ *
+ * @note A field is only meaningful when its corresponding *_valid flag is true.
+ *       A negative pin value means the pin is not specified.
+ */
+typedef struct {
+    at_mfg_params_storage_mode_t mode;                  /*!< where the parameters come from */
+    bool loaded;                                        /*!< the factory_param namespace or partition was read successfully */
+    bool module_valid;
+    bool module_by_id;                                  /*!< legacy partition version <= 2 stores module id instead of name */
+    uint8_t module_id;
+    char module_name[AT_MFG_MODULE_NAME_MAX_LEN + 1];
+    bool tx_power_valid;
+    int8_t tx_power;
+    bool country_valid;
+    uint8_t country_schan;
+    uint8_t country_nchan;
+    char country_cc[3];
+    bool uart_baudrate_valid;
+    int32_t uart_baudrate;
+    bool uart_pins_valid;
+    int8_t uart_port;                                   /*!< -1 if not specified */
+    int32_t uart_tx_pin;
+    int32_t uart_rx_pin;
+    int32_t uart_cts_pin;
+    int32_t uart_rts_pin;
+    at_sys_tune_t sys_tune;
+} at_mfg_params_t;
+
 /**
  * @brief get current module name
  *
@@ -68,6 +143,17 @@ void esp_at_set_module_id_by_str(const char *buffer);
  */
 void at_wkmcu_if_config(at_write_data_fn_t write_data_fn);
 
+/**
+ * @brief buffer the data to be sent to MCU if AT is waiting for MCU to wake up
+ *
+ * @note The buffered data is sent in one burst once MCU is awake or the waiting time is up.
+ *
+ * @return
+ *  - true : the data is buffered
+ *  - false : no wake-up is in progress, the data should be sent directly
+ */
+bool at_wkmcu_write_if_waking(uint8_t *data, int32_t len);
+
 /**
  * @brief set MCU awake state according to AT+SLEEP command
  *
@@ -88,6 +174,15 @@ void esp_at_main_preprocess(void);
  */
 at_mfg_params_storage_mode_t at_get_mfg_params_storage_mode(void);
 
+/**
+ * @brief get the factory parameters decoded at boot
+ *
+ * @note The parameters are read from flash only once, right after the manufacturing nvs partition is initialized.
+ *
+ * @return pointer to the cached factory parameters, never NULL
+ */
+const at_mfg_params_t *at_get_mfg_params(void);
+
 /**
  * @brief Do some things before esp-at is ready.
  *
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #pragma once
+#include "sdkconfig.h"
 #include "esp_err.h"
+#include "esp_at_core.h"
 #include "esp_at_check_config.h"
 
 /**
@@ -21,3 +23,66 @@ esp_err_t esp_at_netif_init(void);
  * @brief This function is used to register all the at command sets.
 */
 void esp_at_cmd_set_register(void);
+
+#ifdef CONFIG_AT_LAZY_CMD_SET_REGISTER
+/**
+ * @brief Register the deferred command sets whose commands appear in the received data.
+ *
+ * @note It is called on the data read from the AT interface, before the data is parsed.
+ *
+ * @param data received data
+ * @param len length of the received data
+*/
+void esp_at_cmd_set_lazy_register_check(const uint8_t *data, int32_t len);
+
+/**
+ * @brief Tell the deferred command set registration whether the AT interface passes data through.
+ *
+ * @note The data received in the transparent transmission mode is not checked for commands.
+ *
+ * @param status AT status
+*/
+void esp_at_cmd_set_lazy_register_status(esp_at_status_type status);
+#else
+static inline void esp_at_cmd_set_lazy_register_check(const uint8_t *data, int32_t len) {}
+static inline void esp_at_cmd_set_lazy_register_status(esp_at_status_type status) {}
+#endif
+
+#ifdef CONFIG_AT_BOOT_PROFILE_SUPPORT
+/**
+ * @brief Record the start of a boot phase in esp_at_init(), the previous phase ends here.
+ *
+ * @param name phase name, must be a string literal
+*/
+void esp_at_boot_phase_begin(const char *name);
+
+/**
+ * @brief Record the end of the current boot phase.
+*/
+void esp_at_boot_phase_end(void);
+
+/**
+ * @brief Record a boot phase which ran on another task, in parallel with the phases of esp_at_init().
+ *
+ * @param name phase name, must be a string literal
+ * @param start_us start time since boot
+ * @param end_us end time since boot
+*/
+void esp_at_boot_phase_record(const char *name, uint32_t start_us, uint32_t end_us);
+#else
+static inline void esp_at_boot_phase_begin(const char *name) {}
+static inline void esp_at_boot_phase_end(void) {}
+static inline void esp_at_boot_phase_record(const char *name, uint32_t start_us, uint32_t end_us) {}
+#endif
+
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+/**
+ * @brief Record a failed heap allocation into the ring which survives a soft reset.
+ *
+ * @note It is called from the heap_caps alloc-failed callback, and it is placed in IRAM.
+ *
+ * @param requested_size requested size of the failed allocation
+ * @param caps requested capabilities of the failed allocation
+*/
+void at_alloc_failed_record(size_t requested_size, uint32_t caps);
+#endif
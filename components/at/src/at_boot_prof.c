@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_at_core.h"
+#include "esp_at.h"
+#include "esp_at_init.h"
+
+#ifdef CONFIG_AT_BOOT_PROFILE_SUPPORT
+#define AT_BOOT_PHASE_MAX               16
+#define AT_BOOTPROF_BUFFER_SIZE         64
+
+typedef struct {
+    const char *name;       /*!< phase name, must be a string literal */
+    uint32_t start_us;      /*!< start time since boot */
+    uint32_t end_us;        /*!< end time since boot, 0 if the phase is not ended yet */
+} at_boot_phase_t;
+
+static at_boot_phase_t s_boot_phases[AT_BOOT_PHASE_MAX];
+static uint8_t s_boot_phase_num;
+static int8_t s_boot_phase_cur = -1;   // the phase of esp_at_init() in progress, -1 if none
+// the boot stages running on other tasks record their phases concurrently
+static portMUX_TYPE s_boot_phase_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int8_t at_boot_phase_add(const char *name, uint32_t start_us, uint32_t end_us)
+{
+    if (s_boot_phase_num >= AT_BOOT_PHASE_MAX) {
+        return -1;
+    }
+    s_boot_phases[s_boot_phase_num].name = name;
+    s_boot_phases[s_boot_phase_num].start_us = start_us;
+    s_boot_phases[s_boot_phase_num].end_us = end_us;
+    return s_boot_phase_num++;
+}
+
+static void at_boot_phase_end_locked(uint32_t now_us)
+{
+    if (s_boot_phase_cur >= 0) {
+        s_boot_phases[s_boot_phase_cur].end_us = now_us;
+        s_boot_phase_cur = -1;
+    }
+}
+
+void esp_at_boot_phase_end(void)
+{
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&s_boot_phase_lock);
+    at_boot_phase_end_locked(now_us);
+    portEXIT_CRITICAL(&s_boot_phase_lock);
+}
+
+void esp_at_boot_phase_begin(const char *name)
+{
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&s_boot_phase_lock);
+    // the previous phase ends where the next one begins
+    at_boot_phase_end_locked(now_us);
+    s_boot_phase_cur = at_boot_phase_add(name, now_us, 0);
+    portEXIT_CRITICAL(&s_boot_phase_lock);
+}
+
+void esp_at_boot_phase_record(const char *name, uint32_t start_us, uint32_t end_us)
+{
+    portENTER_CRITICAL(&s_boot_phase_lock);
+    at_boot_phase_add(name, start_us, end_us);
+    portEXIT_CRITICAL(&s_boot_phase_lock);
+}
+
+static uint8_t at_query_cmd_bootprof(uint8_t *cmd_name)
+{
+    uint8_t buffer[AT_BOOTPROF_BUFFER_SIZE] = {0};
+
+    for (int i = 0; i < s_boot_phase_num; i++) {
+        uint32_t duration_us = s_boot_phases[i].end_us ? (s_boot_phases[i].end_us - s_boot_phases[i].start_us) : 0;
+        int len = snprintf((char *)buffer, AT_BOOTPROF_BUFFER_SIZE, "%s:%d,\"%s\",%u,%u\r\n", cmd_name, i,
+                           s_boot_phases[i].name, s_boot_phases[i].start_us, duration_us);
+        esp_at_port_write_data(buffer, len);
+    }
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static const esp_at_cmd_struct s_at_boot_prof_cmd[] = {
+    {"+BOOTPROF", NULL, at_query_cmd_bootprof, NULL, NULL},
+};
+
+bool esp_at_boot_prof_cmd_regist(void)
+{
+    return esp_at_custom_cmd_array_regist(s_at_boot_prof_cmd, sizeof(s_at_boot_prof_cmd) / sizeof(s_at_boot_prof_cmd[0]));
+}
+
+ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_boot_prof_cmd_regist, 27);
+#endif
@@ -46,47 +46,47 @@ ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_net_cmd_regist, 7);
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_ping_cmd_regist, 8);
 #endif
 
-#ifdef CONFIG_AT_MQTT_COMMAND_SUPPORT
+#if defined(CONFIG_AT_MQTT_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_mqtt_cmd_regist, 9);
 #endif
 
-#ifdef CONFIG_AT_HTTP_COMMAND_SUPPORT
+#if defined(CONFIG_AT_HTTP_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_http_cmd_regist, 10);
 #endif
 
-#ifdef CONFIG_AT_WS_COMMAND_SUPPORT
+#if defined(CONFIG_AT_WS_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_ws_cmd_regist, 11);
 #endif
 
-#ifdef CONFIG_AT_BLE_COMMAND_SUPPORT
+#if defined(CONFIG_AT_BLE_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_ble_cmd_regist, 12);
 #endif
 
-#ifdef CONFIG_AT_BLE_HID_COMMAND_SUPPORT
+#if defined(CONFIG_AT_BLE_HID_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_ble_hid_cmd_regist, 13);
 #endif
 
-#ifdef CONFIG_AT_BLUFI_COMMAND_SUPPORT
+#if defined(CONFIG_AT_BLUFI_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_blufi_cmd_regist, 14);
 #endif
 
-#ifdef CONFIG_AT_BT_COMMAND_SUPPORT
+#if defined(CONFIG_AT_BT_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_bt_cmd_regist, 15);
 #endif
 
-#ifdef CONFIG_AT_BT_SPP_COMMAND_SUPPORT
+#if defined(CONFIG_AT_BT_SPP_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_bt_spp_cmd_regist, 16);
 #endif
 
-#ifdef CONFIG_AT_BT_A2DP_COMMAND_SUPPORT
+#if defined(CONFIG_AT_BT_A2DP_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_bt_a2dp_cmd_regist, 17);
 #endif
 
-#ifdef CONFIG_AT_FS_COMMAND_SUPPORT
+#if defined(CONFIG_AT_FS_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_fs_cmd_regist, 18);
 #endif
 
-#ifdef CONFIG_AT_DRIVER_COMMAND_SUPPORT
+#if defined(CONFIG_AT_DRIVER_COMMAND_SUPPORT) && !defined(CONFIG_AT_LAZY_CMD_SET_REGISTER)
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_driver_cmd_regist, 19);
 #endif
 
@@ -94,6 +94,189 @@ ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_driver_cmd_regist, 19);
 ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_eth_cmd_regist, 20);
 #endif
 
+#ifdef CONFIG_AT_LAZY_CMD_SET_REGISTER
+#define AT_LAZY_CMD_NAME_MAX_LEN    16
+
+typedef struct {
+    const char *prefix;     /*!< command name prefix without "AT+", which triggers the registration */
+    bool (*fn)(void);       /*!< Pointer to an AT command set register function */
+    const char *name;       /*!< Name of the AT command set */
+    bool registered;        /*!< whether the command set has been registered */
+} at_lazy_cmd_set_t;
+
+// the heavy command sets which are registered on their first use
+static at_lazy_cmd_set_t s_lazy_cmd_sets[] = {
+#ifdef CONFIG_AT_MQTT_COMMAND_SUPPORT
+    {"MQTT", esp_at_mqtt_cmd_regist, "esp_at_mqtt_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_HTTP_COMMAND_SUPPORT
+    {"HTTP", esp_at_http_cmd_regist, "esp_at_http_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_WS_COMMAND_SUPPORT
+    {"WS", esp_at_ws_cmd_regist, "esp_at_ws_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_BLE_COMMAND_SUPPORT
+    {"BLE", esp_at_ble_cmd_regist, "esp_at_ble_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_BLE_HID_COMMAND_SUPPORT
+    {"BLEHID", esp_at_ble_hid_cmd_regist, "esp_at_ble_hid_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_BLUFI_COMMAND_SUPPORT
+    {"BLUFI", esp_at_blufi_cmd_regist, "esp_at_blufi_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_BT_COMMAND_SUPPORT
+    {"BT", esp_at_bt_cmd_regist, "esp_at_bt_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_BT_SPP_COMMAND_SUPPORT
+    {"BTSPP", esp_at_bt_spp_cmd_regist, "esp_at_bt_spp_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_BT_A2DP_COMMAND_SUPPORT
+    {"BTA2DP", esp_at_bt_a2dp_cmd_regist, "esp_at_bt_a2dp_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_FS_COMMAND_SUPPORT
+    {"FS", esp_at_fs_cmd_regist, "esp_at_fs_cmd_regist", false},
+#endif
+#ifdef CONFIG_AT_DRIVER_COMMAND_SUPPORT
+    {"DRV", esp_at_driver_cmd_regist, "esp_at_driver_cmd_regist", false},
+#endif
+    {NULL, NULL, NULL, false},
+};
+
+// command name parser state, which survives across the read chunks
+typedef enum {
+    AT_LAZY_STATE_IDLE = 0,
+    AT_LAZY_STATE_A,
+    AT_LAZY_STATE_T,
+    AT_LAZY_STATE_NAME,
+} at_lazy_state_t;
+
+static at_lazy_state_t s_lazy_state;
+static char s_lazy_name[AT_LAZY_CMD_NAME_MAX_LEN + 1];
+static uint8_t s_lazy_name_len;
+static uint8_t s_lazy_pending_num;
+static bool s_lazy_override_check;  // the ESP_AT_CMD_SET_INIT_FN and ESP_AT_CMD_SET_LAST_INIT_FN sets are being registered
+static bool s_lazy_data_mode;       // the received data is the payload of a command, not command lines
+static bool s_lazy_transmit_mode;   // the received data is passed through
+
+bool __real_esp_at_custom_cmd_array_regist(const esp_at_cmd_struct *custom_at_cmd_array, uint32_t cmd_num);
+void __real_esp_at_port_enter_specific(esp_at_port_specific_callback_t callback);
+void __real_esp_at_port_exit_specific(void);
+
+static void at_lazy_cmd_set_do_register(at_lazy_cmd_set_t *set)
+{
+    // a failed registration is not retried, which is the same as the boot-time registration
+    set->registered = true;
+    s_lazy_pending_num--;
+
+    // the commands of the set itself are not overrides
+    bool override_check = s_lazy_override_check;
+    s_lazy_override_check = false;
+    bool ret = set->fn();
+    s_lazy_override_check = override_check;
+    if (!ret) {
+        ESP_LOGE(TAG, "%s failed", set->name);
+    } else {
+        ESP_LOGD(TAG, "%s success (lazy)", set->name);
+    }
+}
+
+static void at_lazy_cmd_set_match(const char *cmd_name, uint8_t len)
+{
+    // AT+CMD? lists all the commands, so all the command sets should be there
+    bool all = (len == 3 && memcmp(cmd_name, "CMD", 3) == 0);
+
+    for (at_lazy_cmd_set_t *set = s_lazy_cmd_sets; set->prefix; ++set) {
+        if (set->registered) {
+            continue;
+        }
+        size_t prefix_len = strlen(set->prefix);
+        if (all || (len >= prefix_len && memcmp(cmd_name, set->prefix, prefix_len) == 0)) {
+            at_lazy_cmd_set_do_register(set);
+        }
+    }
+}
+
+/*
+ * The deferred command sets used to be registered before the ESP_AT_CMD_SET_INIT_FN and
+ * ESP_AT_CMD_SET_LAST_INIT_FN sets, which may override their commands. A deferred set whose
+ * command is registered by one of those sets is registered right before it, so that the override
+ * still replaces the built-in command. This is linked with -Wl,--wrap=esp_at_custom_cmd_array_regist.
+ */
+bool __wrap_esp_at_custom_cmd_array_regist(const esp_at_cmd_struct *custom_at_cmd_array, uint32_t cmd_num)
+{
+    if (s_lazy_override_check && s_lazy_pending_num && custom_at_cmd_array) {
+        for (uint32_t i = 0; i < cmd_num; i++) {
+            const char *name = custom_at_cmd_array[i].at_cmdName;
+            if (name && name[0] == '+') {
+                at_lazy_cmd_set_match(name + 1, strnlen(name + 1, UINT8_MAX));
+            }
+        }
+    }
+    return __real_esp_at_custom_cmd_array_regist(custom_at_cmd_array, cmd_num);
+}
+
+// the payload after the ">" prompt is not parsed as commands, -Wl,--wrap=esp_at_port_enter_specific
+void __wrap_esp_at_port_enter_specific(esp_at_port_specific_callback_t callback)
+{
+    s_lazy_data_mode = true;
+    s_lazy_state = AT_LAZY_STATE_IDLE;
+    __real_esp_at_port_enter_specific(callback);
+}
+
+// -Wl,--wrap=esp_at_port_exit_specific
+void __wrap_esp_at_port_exit_specific(void)
+{
+    __real_esp_at_port_exit_specific();
+    s_lazy_data_mode = false;
+    s_lazy_state = AT_LAZY_STATE_IDLE;
+}
+
+void esp_at_cmd_set_lazy_register_status(esp_at_status_type status)
+{
+    s_lazy_transmit_mode = (status == ESP_AT_STATUS_TRANSMIT);
+    s_lazy_state = AT_LAZY_STATE_IDLE;
+}
+
+void esp_at_cmd_set_lazy_register_check(const uint8_t *data, int32_t len)
+{
+    // only the command lines are looked at, the data may contain anything
+    if (s_lazy_pending_num == 0 || !data || s_lazy_data_mode || s_lazy_transmit_mode) {
+        return;
+    }
+
+    for (int32_t i = 0; i < len; i++) {
+        char c = (char)data[i];
+        switch (s_lazy_state) {
+        case AT_LAZY_STATE_IDLE:
+            s_lazy_state = (c == 'A') ? AT_LAZY_STATE_A : AT_LAZY_STATE_IDLE;
+            break;
+        case AT_LAZY_STATE_A:
+            s_lazy_state = (c == 'T') ? AT_LAZY_STATE_T : ((c == 'A') ? AT_LAZY_STATE_A : AT_LAZY_STATE_IDLE);
+            break;
+        case AT_LAZY_STATE_T:
+            s_lazy_name_len = 0;
+            s_lazy_state = (c == '+') ? AT_LAZY_STATE_NAME : ((c == 'A') ? AT_LAZY_STATE_A : AT_LAZY_STATE_IDLE);
+            break;
+        case AT_LAZY_STATE_NAME:
+            if (((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) && s_lazy_name_len < AT_LAZY_CMD_NAME_MAX_LEN) {
+                s_lazy_name[s_lazy_name_len++] = c;
+                break;
+            }
+            // the command name ends with '=', '?', '\r' or any other character
+            at_lazy_cmd_set_match(s_lazy_name, s_lazy_name_len);
+            if (s_lazy_pending_num == 0) {
+                return;
+            }
+            s_lazy_state = (c == 'A') ? AT_LAZY_STATE_A : AT_LAZY_STATE_IDLE;
+            break;
+        default:
+            s_lazy_state = AT_LAZY_STATE_IDLE;
+            break;
+        }
+    }
+}
+#endif
+
 void esp_at_cmd_set_register(void)
 {
     at_cmd_set_register_t *p;
@@ -110,6 +293,13 @@ void esp_at_cmd_set_register(void)
         }
     }
 
+#ifdef CONFIG_AT_LAZY_CMD_SET_REGISTER
+    // the heavy command sets are only recorded here, and registered once one of their commands is received,
+    // or once a later command set overrides one of their commands
+    s_lazy_pending_num = sizeof(s_lazy_cmd_sets) / sizeof(s_lazy_cmd_sets[0]) - 1;
+    s_lazy_override_check = true;
+#endif
+
     // register the at command set which initialized by ESP_AT_CMD_SET_INIT_FN
     extern at_cmd_set_register_t _at_cmd_set_init_fn_array_start;
     extern at_cmd_set_register_t _at_cmd_set_init_fn_array_end;
@@ -133,4 +323,8 @@ void esp_at_cmd_set_register(void)
             ESP_LOGD(TAG, "%s success", p->name);
         }
     }
+
+#ifdef CONFIG_AT_LAZY_CMD_SET_REGISTER
+    s_lazy_override_check = false;
+#endif
 }
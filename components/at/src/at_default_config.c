@@ -5,6 +5,7 @@
  */
 #include "sdkconfig.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "nvs_flash.h"
@@ -21,15 +22,16 @@
 
 // unknown module name if not defined
 #define ESP_AT_UNKNOWN_STR      "Unknown"
+#define AT_MODULE_INDEX_EMPTY   0xFFFF
 
-typedef struct {
-    char *module_name;
-    char *ota_token;
-    char *ota_ssl_token;
-} at_module_info_t;
+// bounds of the values in the "sys_tune" namespace of the manufacturing nvs
+#define AT_SYS_TUNE_STACK_SIZE_MIN      2048
+#define AT_SYS_TUNE_STACK_SIZE_MAX      16384
+#define AT_SYS_TUNE_BUFFER_SIZE_MIN     512
+#define AT_SYS_TUNE_BUFFER_SIZE_MAX     16384
 
 // static variables
-static uint8_t s_module_id = 0x0;
+static uint16_t s_module_id = 0x0;
 static const at_module_info_t s_module_info[] = {
 #if defined(CONFIG_IDF_TARGET_ESP32)
     {"WROOM-32",        CONFIG_ESP_AT_OTA_TOKEN_WROOM32,       CONFIG_ESP_AT_OTA_SSL_TOKEN_WROOM32 },        // default:ESP32-WROOM-32
@@ -74,15 +76,87 @@ static const at_module_info_t s_module_info[] = {
 };
 static const char *TAG = "at-default";
 
-// the initialization of module information
-const char *esp_at_get_current_module_name(void)
+// hashed index of module names, built on the first lookup by name
+static uint16_t *s_module_index;
+static uint32_t s_module_index_size;
+
+// the additional modules defined by ESP_AT_MODULE_INFO_DEFINE()
+extern const at_module_info_t _at_module_info_array_start;
+extern const at_module_info_t _at_module_info_array_end;
+
+static uint32_t at_module_info_num(void)
+{
+    return sizeof(s_module_info) / sizeof(s_module_info[0]) + (&_at_module_info_array_end - &_at_module_info_array_start);
+}
+
+static const at_module_info_t *at_module_info_get(uint32_t id)
+{
+    uint32_t builtin_num = sizeof(s_module_info) / sizeof(s_module_info[0]);
+    if (id < builtin_num) {
+        return &s_module_info[id];
+    }
+    if (id < at_module_info_num()) {
+        return &_at_module_info_array_start + (id - builtin_num);
+    }
+
+    return NULL;
+}
+
+static uint32_t at_module_name_hash(const char *name)
 {
-    if (sizeof(s_module_info) == 0) {
-        return ESP_AT_UNKNOWN_STR;
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
     }
+    return hash;
+}
 
-    if (s_module_id < sizeof(s_module_info) / sizeof(s_module_info[0])) {
-        return s_module_info[s_module_id].module_name;
+static bool at_module_index_build(void)
+{
+    uint32_t num = at_module_info_num();
+    if (num == 0 || num >= AT_MODULE_INDEX_EMPTY) {
+        return false;
+    }
+
+    // open addressing with a load factor no more than 0.5, the size goes beyond 16 bits for the largest tables
+    uint32_t size = 4;
+    while (size < num * 2) {
+        size <<= 1;
+    }
+    uint16_t *index = (uint16_t *)malloc(size * sizeof(uint16_t));
+    if (!index) {
+        return false;
+    }
+    memset(index, 0xFF, size * sizeof(uint16_t));
+
+    for (uint32_t i = 0; i < num; ++i) {
+        const char *name = at_module_info_get(i)->module_name;
+        uint32_t slot = at_module_name_hash(name) & (size - 1);
+        while (index[slot] != AT_MODULE_INDEX_EMPTY) {
+            // the first module with the same name wins, which is the same as the linear search
+            if (strcmp(at_module_info_get(index[slot])->module_name, name) == 0) {
+                break;
+            }
+            slot = (slot + 1) & (size - 1);
+        }
+        if (index[slot] == AT_MODULE_INDEX_EMPTY) {
+            index[slot] = i;
+        }
+    }
+
+    s_module_index = index;
+    s_module_index_size = size;
+    return true;
+}
+
+// the initialization of module information
+const char *esp_at_get_current_module_name(void)
+{
+    const at_module_info_t *info = at_module_info_get(s_module_id);
+    if (info) {
+        return info->module_name;
     }
 
     return ESP_AT_UNKNOWN_STR;
@@ -100,12 +174,26 @@ void esp_at_set_module_id(uint32_t id)
 
 void esp_at_set_module_id_by_str(const char *buffer)
 {
-    for (int i = 0; i < sizeof(s_module_info) / sizeof(s_module_info[0]); ++i) {
-        if (strcmp(buffer, s_module_info[i].module_name) == 0) {
-            s_module_id = i;
-            break;
+    if (!s_module_index && !at_module_index_build()) {
+        // fall back to the linear search
+        for (uint32_t i = 0; i < at_module_info_num(); ++i) {
+            if (strcmp(buffer, at_module_info_get(i)->module_name) == 0) {
+                s_module_id = i;
+                break;
+            }
         }
+        return;
     }
+
+    uint32_t slot = at_module_name_hash(buffer) & (s_module_index_size - 1);
+    while (s_module_index[slot] != AT_MODULE_INDEX_EMPTY) {
+        if (strcmp(buffer, at_module_info_get(s_module_index[slot])->module_name) == 0) {
+            s_module_id = s_module_index[slot];
+            return;
+        }
+        slot = (slot + 1) & (s_module_index_size - 1);
+    }
+    ESP_LOGW(TAG, "unknown module: %s", buffer);
 }
 
 /*-------------------------------------------------------------------------------------
@@ -154,9 +242,19 @@ __attribute__((weak)) void esp_at_log_write(esp_log_level_t level, const char *t
     }
 }
 
+// return the value tuned in the "sys_tune" namespace of the manufacturing nvs, or the default value
+static uint32_t at_sys_tune_value(uint32_t tuned, uint32_t def, uint32_t min, uint32_t max)
+{
+    if (tuned == 0) {
+        return def;
+    }
+    return at_min(at_max(tuned, min), max);
+}
+
 uint32_t esp_at_get_process_task_stack_size(void)
 {
-    return CONFIG_AT_PROCESS_TASK_STACK_SIZE;
+    return at_sys_tune_value(at_get_mfg_params()->sys_tune.process_task_stack_size, CONFIG_AT_PROCESS_TASK_STACK_SIZE,
+                             AT_SYS_TUNE_STACK_SIZE_MIN, AT_SYS_TUNE_STACK_SIZE_MAX);
 }
 
 /**************************************************************************
@@ -177,12 +275,15 @@ esp_err_t esp_at_get_smartconfig_start_config(smartconfig_start_config_t *config
 #ifdef CONFIG_AT_NET_COMMAND_SUPPORT
 uint32_t esp_at_get_socket_task_stack_size(void)
 {
-    return CONFIG_AT_SOCKET_TASK_STACK_SIZE;
+    return at_sys_tune_value(at_get_mfg_params()->sys_tune.socket_task_stack_size, CONFIG_AT_SOCKET_TASK_STACK_SIZE,
+                             AT_SYS_TUNE_STACK_SIZE_MIN, AT_SYS_TUNE_STACK_SIZE_MAX);
 }
 
 uint32_t esp_at_get_netconn_max_count(void)
 {
-    return CONFIG_AT_SOCKET_MAX_CONN_NUM;
+    // lwip resources are sized at compile time, so the count can only be reduced
+    return at_sys_tune_value(at_get_mfg_params()->sys_tune.netconn_max_count, CONFIG_AT_SOCKET_MAX_CONN_NUM,
+                             1, CONFIG_AT_SOCKET_MAX_CONN_NUM);
 }
 #endif
 
@@ -192,12 +293,14 @@ uint32_t esp_at_get_netconn_max_count(void)
 #ifdef CONFIG_AT_HTTP_COMMAND_SUPPORT
 uint32_t esp_at_get_http_tx_buffer_size(void)
 {
-    return CONFIG_AT_HTTP_TX_BUFFER_SIZE;
+    return at_sys_tune_value(at_get_mfg_params()->sys_tune.http_tx_buffer_size, CONFIG_AT_HTTP_TX_BUFFER_SIZE,
+                             AT_SYS_TUNE_BUFFER_SIZE_MIN, AT_SYS_TUNE_BUFFER_SIZE_MAX);
 }
 
 uint32_t esp_at_get_http_rx_buffer_size(void)
 {
-    return CONFIG_AT_HTTP_RX_BUFFER_SIZE;
+    return at_sys_tune_value(at_get_mfg_params()->sys_tune.http_rx_buffer_size, CONFIG_AT_HTTP_RX_BUFFER_SIZE,
+                             AT_SYS_TUNE_BUFFER_SIZE_MIN, AT_SYS_TUNE_BUFFER_SIZE_MAX);
 }
 #endif
 
@@ -207,17 +310,16 @@ uint32_t esp_at_get_http_rx_buffer_size(void)
 #ifdef CONFIG_AT_OTA_SUPPORT
 const char *esp_at_get_ota_token_by_id(uint32_t id, at_ota_mode_t ota_mode)
 {
-    char *ota_token = ESP_AT_UNKNOWN_STR;
-    if (sizeof(s_module_info) == 0) {
+    const char *ota_token = ESP_AT_UNKNOWN_STR;
+    const at_module_info_t *info = at_module_info_get(id);
+    if (!info) {
         return ota_token;
     }
 
-    if (id < sizeof(s_module_info) / sizeof(s_module_info[0])) {
-        if (ota_mode == ESP_AT_OTA_MODE_NORMAL) {
-            ota_token = s_module_info[id].ota_token;
-        } else if (ota_mode == ESP_AT_OTA_MODE_SSL) {
-            ota_token = s_module_info[id].ota_ssl_token;
-        }
+    if (ota_mode == ESP_AT_OTA_MODE_NORMAL) {
+        ota_token = info->ota_token;
+    } else if (ota_mode == ESP_AT_OTA_MODE_SSL) {
+        ota_token = info->ota_ssl_token;
     }
 
     return ota_token;
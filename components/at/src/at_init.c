@@ -6,11 +6,15 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include "sdkconfig.h"
 #include "nvs_flash.h"
 #include "esp_event.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
 
 #if defined(CONFIG_BT_ENABLED)
 #include "esp_bt.h"
@@ -18,6 +22,11 @@
 
 #ifdef CONFIG_AT_DEBUG
 #include "esp_task_wdt.h"
+#include "esp_idf_version.h"
+#endif
+
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+#include "esp_timer.h"
 #endif
 
 #if defined(CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) && !defined(CONFIG_BOOTLOADER_COMPRESSED_ENABLED)
@@ -29,14 +38,34 @@
 #include "esp_at_init.h"
 #include "esp_at_interface.h"
 
+#define AT_VERSION_BUFFER_SIZE      256
+
 // global variables
 const char *g_at_mfg_nvs_name = "mfg_nvs";
 
 // static variables
 static const char *s_ready_str = "\r\nready\r\n";
+static const char s_at_compile_time_str[] = "compile time(" ESP_AT_PROJECT_COMMIT_ID "):" __DATE__ " " __TIME__ "\r\n";
 static at_mfg_params_storage_mode_t s_at_param_mode = AT_PARAMS_NONE;
+static at_mfg_params_t s_at_mfg_params;
 static const char *TAG = "at-init";
 
+// boot stages which can run in parallel with the main boot flow
+#define AT_BOOT_STAGE_WIFI_INIT_BIT         BIT0
+#define AT_BOOT_STAGE_BT_MEM_RELEASE_BIT    BIT1
+#define AT_BOOT_STAGE_ALL_BITS              (AT_BOOT_STAGE_WIFI_INIT_BIT | AT_BOOT_STAGE_BT_MEM_RELEASE_BIT)
+#define AT_BOOT_STAGE_TASK_STACK_SIZE       4096
+
+typedef struct {
+    const char *name;       /*!< stage name, also used as the task name */
+    void (*fn)(void);       /*!< stage function */
+    EventBits_t done_bit;   /*!< bit set once the stage is done */
+} at_boot_stage_t;
+
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+static EventGroupHandle_t s_boot_stage_done;
+#endif
+
 #ifdef CONFIG_AT_WIFI_COMMAND_SUPPORT
 esp_err_t at_wifi_init(void)
 {
@@ -77,13 +106,22 @@ esp_err_t esp_at_netif_init(void)
 #endif
 }
 
+static void at_version_str_build(char *buffer, size_t size)
+{
+    // the compile-time part is a literal, only the bin version is formatted at runtime
+    int ret = snprintf(buffer, size, "%s", s_at_compile_time_str);
+
+#ifdef CONFIG_APP_PROJECT_VER
+    if (ret > 0 && (size_t)ret < size) {
+        snprintf(buffer + ret, size - ret, "Bin version:%s(%s)\r\n", CONFIG_APP_PROJECT_VER, esp_at_get_current_module_name());
+    }
+#endif
+}
+
 static void at_module_init(void)
 {
-#define AT_TEMP_BUFFER_SIZE     256
-    int ret = 0;
-    uint8_t *version = (uint8_t *)malloc(AT_TEMP_BUFFER_SIZE);
-    ret = snprintf((char *)version, AT_TEMP_BUFFER_SIZE,
-                   "compile time(%s):%s %s\r\n", ESP_AT_PROJECT_COMMIT_ID, __DATE__, __TIME__);
+    // the AT core keeps its own copy of the version, so the buffer only lives during the init
+    char version[AT_VERSION_BUFFER_SIZE];
 
 #ifdef CONFIG_APP_PROJECT_VER
 #ifdef ESP_AT_FIRMWARE_FROM
@@ -91,22 +129,20 @@ static void at_module_init(void)
 #else
     ESP_AT_LOGI(TAG, "%s (unknown)", CONFIG_APP_PROJECT_VER);
 #endif
+#endif
 
-    ret = snprintf((char *)version + ret, AT_TEMP_BUFFER_SIZE - ret,
-                   "Bin version:%s(%s)\r\n", CONFIG_APP_PROJECT_VER, esp_at_get_current_module_name());
+#if CONFIG_AT_DEBUG
+    // the same buffer holds the core version first
+    int ret = esp_at_get_core_version(version, sizeof(version));
+    ESP_AT_LOGI(TAG, "%.*sSDK version:%s", ret, version, esp_get_idf_version());
 #endif
 
+    at_version_str_build(version, sizeof(version));
 #if CONFIG_AT_DEBUG
-    char *versions = (char *)malloc(AT_TEMP_BUFFER_SIZE);
-    ret = esp_at_get_core_version((char *)versions, AT_TEMP_BUFFER_SIZE);
-    ret += snprintf((char *)versions + ret, AT_TEMP_BUFFER_SIZE - ret, "SDK version:%s\r\n", esp_get_idf_version());
-    ret += snprintf((char *)versions + ret, AT_TEMP_BUFFER_SIZE - ret, "%s", version);
-    ESP_AT_LOGI(TAG, "%.*s", ret, versions);
-    free(versions);
+    ESP_AT_LOGI(TAG, "%s", version);
 #endif
 
-    esp_at_module_init(version);
-    free(version);
+    esp_at_module_init((const uint8_t *)version);
     ESP_LOGD(TAG, "at module init done");
 }
 
@@ -145,47 +181,17 @@ __attribute__((weak)) void esp_at_ready_before(void)
 
 static esp_err_t at_module_config_init(void)
 {
-    char buffer[AT_BUFFER_ON_STACK_SIZE] = {0};
-
-    at_mfg_params_storage_mode_t mode = at_get_mfg_params_storage_mode();
-    if (mode == AT_PARAMS_IN_MFG_NVS) {
-        nvs_handle handle;
-        if (nvs_open_from_partition(g_at_mfg_nvs_name, "factory_param", NVS_READONLY, &handle) != ESP_OK) {
-            ESP_AT_LOGE(TAG, "open factory_param failed");
-            return ESP_FAIL;
-        }
-        // read module name from manufacturing nvs
-        size_t len = AT_BUFFER_ON_STACK_SIZE;
-        if (esp_at_nvs_get_str(handle, "module_name", buffer, &len) != ESP_OK) {
-            nvs_close(handle);
-            return ESP_FAIL;
-        }
-        esp_at_set_module_id_by_str(buffer);
-        nvs_close(handle);
-    } else if (mode == AT_PARAMS_IN_PARTITION) {
-        // deprecated way
-        const esp_partition_t *partition = esp_at_custom_partition_find(0x40, 0xff, "factory_param");
-        if (!partition) {
-            ESP_AT_LOGE(TAG, "factory_param partition missed");
-            return ESP_FAIL;
-        }
-        if (esp_partition_read(partition, 0, buffer, AT_BUFFER_ON_STACK_SIZE) != ESP_OK) {
-            return ESP_FAIL;
-        }
-        // check magic flag, should be 0xfc 0xfc
-        if (buffer[0] != 0xFC || buffer[1] != 0xFC) {
-            return ESP_FAIL;
-        }
-        uint8_t version = buffer[2];
-        if (version <= 2) {
-            esp_at_set_module_id(buffer[3]);
-        } else {
-            const char *module_name = buffer + 56;
-            esp_at_set_module_id_by_str(module_name);
-        }
-    } else {
+    if (s_at_mfg_params.mode == AT_PARAMS_NONE) {
+        return ESP_FAIL;
+    }
+    if (!s_at_mfg_params.module_valid) {
         return ESP_FAIL;
     }
+    if (s_at_mfg_params.module_by_id) {
+        esp_at_set_module_id(s_at_mfg_params.module_id);
+    } else {
+        esp_at_set_module_id_by_str(s_at_mfg_params.module_name);
+    }
     ESP_AT_LOGI(TAG, "module_name: %s", esp_at_get_current_module_name());
 
     return ESP_OK;
@@ -194,88 +200,27 @@ static esp_err_t at_module_config_init(void)
 #ifdef CONFIG_AT_WIFI_COMMAND_SUPPORT
 static esp_err_t at_wifi_config_init(void)
 {
-    char buffer[AT_BUFFER_ON_STACK_SIZE] = {0};
-
-    at_mfg_params_storage_mode_t mode = at_get_mfg_params_storage_mode();
-    if (mode == AT_PARAMS_IN_MFG_NVS) {
-        nvs_handle handle;
-        if (nvs_open_from_partition(g_at_mfg_nvs_name, "factory_param", NVS_READONLY, &handle) != ESP_OK) {
-            ESP_AT_LOGE(TAG, "open factory_param failed");
-            return ESP_FAIL;
-
-        }
-        esp_wifi_set_storage(WIFI_STORAGE_RAM);
+    // keep the wifi configuration in flash unless the factory parameters are really there
+    if (!s_at_mfg_params.loaded) {
+        return ESP_FAIL;
+    }
+    esp_wifi_set_storage(WIFI_STORAGE_RAM);
 
-        // max tx power
-        int8_t tx_power = -1;
-        if (nvs_get_i8(handle, "max_tx_power", &tx_power) != ESP_OK) {
-            nvs_close(handle);
-            return ESP_FAIL;
-        }
-        esp_err_t ret = esp_wifi_set_max_tx_power(tx_power);
-        ESP_AT_LOGI(TAG, "max tx power=%d, ret=%d", tx_power, ret);
+    // max tx power
+    if (s_at_mfg_params.tx_power_valid) {
+        esp_err_t ret = esp_wifi_set_max_tx_power(s_at_mfg_params.tx_power);
+        ESP_AT_LOGI(TAG, "max tx power=%d, ret=%d", s_at_mfg_params.tx_power, ret);
+    }
 
-        // country code
+    // country code
+    if (s_at_mfg_params.country_valid) {
         wifi_country_t country;
         memset(&country, 0x0, sizeof(country));
-        if (nvs_get_u8(handle, "start_channel", &country.schan) != ESP_OK) {
-            nvs_close(handle);
-            return ESP_FAIL;
-        }
-        if (nvs_get_u8(handle, "channel_num", &country.nchan) != ESP_OK) {
-            nvs_close(handle);
-            return ESP_FAIL;
-        }
-        size_t len = AT_BUFFER_ON_STACK_SIZE;
-        if (esp_at_nvs_get_str(handle, "country_code", buffer, &len) != ESP_OK) {
-            nvs_close(handle);
-            return ESP_FAIL;
-        }
-        memcpy(country.cc, buffer, sizeof(country.cc));
+        country.schan = s_at_mfg_params.country_schan;
+        country.nchan = s_at_mfg_params.country_nchan;
+        memcpy(country.cc, s_at_mfg_params.country_cc, sizeof(country.cc));
         country.policy = WIFI_COUNTRY_POLICY_MANUAL;
         esp_wifi_set_country(&country);
-        nvs_close(handle);
-    } else if (mode == AT_PARAMS_IN_PARTITION) {
-        // deprecated way
-        const esp_partition_t *partition = esp_at_custom_partition_find(0x40, 0xff, "factory_param");
-        if (!partition) {
-            ESP_AT_LOGE(TAG, "factory_param partition missed");
-            return ESP_FAIL;
-        }
-        if (esp_partition_read(partition, 0, buffer, AT_BUFFER_ON_STACK_SIZE) != ESP_OK) {
-            return ESP_FAIL;
-        }
-        // check magic flag, should be 0xfc 0xfc
-        if (buffer[0] != 0xFC || buffer[1] != 0xFC) {
-            return ESP_FAIL;
-        }
-        esp_wifi_set_storage(WIFI_STORAGE_RAM);
-
-        // max tx power
-        uint8_t version = buffer[2];
-        if (buffer[4] != 0xFF) {
-            if ((version != 1) || ((version == 1) && (buffer[4] >= 10))) {
-                esp_err_t ret = esp_wifi_set_max_tx_power((int8_t)buffer[4]);
-                ESP_AT_LOGI(TAG, "max tx power=%d, ret=%d", buffer[4], ret);
-            }
-        }
-
-        // country code
-        wifi_country_t country;
-        memset(&country, 0x0, sizeof(country));
-        if ((buffer[6] != 0xFF) && (buffer[7] != 0xFF) && (buffer[8] != 0xFF)) {
-            if ((buffer[6] < 1) || (buffer[7] > 14) || (buffer[7] < buffer[6])) {
-                ESP_AT_LOGE(TAG, "invalid country code, s:%d n:%d", buffer[6], buffer[7]);
-                return ESP_FAIL;
-            }
-            country.schan = buffer[6];
-            country.nchan = buffer[7] - buffer[6] + 1;
-            memcpy(country.cc, &buffer[8], sizeof(country.cc));
-            country.policy = WIFI_COUNTRY_POLICY_MANUAL;
-            esp_wifi_set_country(&country);
-        }
-    } else {
-        return ESP_FAIL;
     }
 
     ESP_LOGD(TAG, "at wifi init done");
@@ -283,13 +228,154 @@ static esp_err_t at_wifi_config_init(void)
 }
 #endif
 
+static void at_mfg_params_load_from_nvs(at_mfg_params_t *params)
+{
+    nvs_handle handle;
+    if (nvs_open_from_partition(g_at_mfg_nvs_name, "factory_param", NVS_READONLY, &handle) != ESP_OK) {
+        ESP_AT_LOGE(TAG, "open factory_param failed");
+        return;
+    }
+    params->loaded = true;
+
+    char buffer[AT_BUFFER_ON_STACK_SIZE] = {0};
+
+    // module name
+    size_t len = AT_BUFFER_ON_STACK_SIZE;
+    if (esp_at_nvs_get_str(handle, "module_name", buffer, &len) == ESP_OK) {
+        snprintf(params->module_name, sizeof(params->module_name), "%s", buffer);
+        params->module_valid = true;
+    }
+
+    // max tx power
+    if (nvs_get_i8(handle, "max_tx_power", &params->tx_power) == ESP_OK) {
+        params->tx_power_valid = true;
+    }
+
+    // country code
+    len = AT_BUFFER_ON_STACK_SIZE;
+    memset(buffer, 0x0, sizeof(buffer));
+    if (nvs_get_u8(handle, "start_channel", &params->country_schan) == ESP_OK
+            && nvs_get_u8(handle, "channel_num", &params->country_nchan) == ESP_OK
+            && esp_at_nvs_get_str(handle, "country_code", buffer, &len) == ESP_OK) {
+        memcpy(params->country_cc, buffer, sizeof(params->country_cc));
+        params->country_valid = true;
+    }
+
+    // uart baudrate, optional
+    if (nvs_get_i32(handle, "uart_baudrate", &params->uart_baudrate) == ESP_OK) {
+        params->uart_baudrate_valid = true;
+    }
+
+    // uart port and pins, all of them are required
+    if (nvs_get_i8(handle, "uart_port", &params->uart_port) == ESP_OK
+            && nvs_get_i32(handle, "uart_tx_pin", &params->uart_tx_pin) == ESP_OK
+            && nvs_get_i32(handle, "uart_rx_pin", &params->uart_rx_pin) == ESP_OK
+            && nvs_get_i32(handle, "uart_cts_pin", &params->uart_cts_pin) == ESP_OK
+            && nvs_get_i32(handle, "uart_rts_pin", &params->uart_rts_pin) == ESP_OK) {
+        params->uart_pins_valid = true;
+    }
+
+    nvs_close(handle);
+}
+
+static void at_mfg_sys_tune_load_from_nvs(at_sys_tune_t *tune)
+{
+    nvs_handle handle;
+    // the namespace is optional
+    if (nvs_open_from_partition(g_at_mfg_nvs_name, "sys_tune", NVS_READONLY, &handle) != ESP_OK) {
+        return;
+    }
+
+    nvs_get_u32(handle, "proc_stack", &tune->process_task_stack_size);
+    nvs_get_u32(handle, "sock_stack", &tune->socket_task_stack_size);
+    nvs_get_u32(handle, "netconn_max", &tune->netconn_max_count);
+    nvs_get_u32(handle, "http_tx_buf", &tune->http_tx_buffer_size);
+    nvs_get_u32(handle, "http_rx_buf", &tune->http_rx_buffer_size);
+    nvs_get_u32(handle, "intf_stack", &tune->intf_task_stack_size);
+    nvs_get_u8(handle, "intf_prio", &tune->intf_task_priority);
+    nvs_get_i8(handle, "intf_core", &tune->intf_task_core_id);
+    nvs_close(handle);
+
+    ESP_AT_LOGI(TAG, "sys_tune: proc_stack=%u sock_stack=%u netconn_max=%u http_buf=%u/%u intf=%u/%u/%d",
+                tune->process_task_stack_size, tune->socket_task_stack_size, tune->netconn_max_count,
+                tune->http_tx_buffer_size, tune->http_rx_buffer_size,
+                tune->intf_task_stack_size, tune->intf_task_priority, tune->intf_task_core_id);
+}
+
+static void at_mfg_params_load_from_partition(at_mfg_params_t *params, const esp_partition_t *partition)
+{
+    // deprecated way
+    uint8_t buffer[AT_BUFFER_ON_STACK_SIZE] = {0};
+    if (esp_partition_read(partition, 0, buffer, AT_BUFFER_ON_STACK_SIZE) != ESP_OK) {
+        return;
+    }
+    // check magic flag, should be 0xfc 0xfc
+    if (buffer[0] != 0xFC || buffer[1] != 0xFC) {
+        return;
+    }
+    params->loaded = true;
+
+    // module id or module name
+    uint8_t version = buffer[2];
+    if (version <= 2) {
+        params->module_by_id = true;
+        params->module_id = buffer[3];
+    } else {
+        snprintf(params->module_name, sizeof(params->module_name), "%.*s",
+                 AT_BUFFER_ON_STACK_SIZE - 56, (const char *)buffer + 56);
+    }
+    params->module_valid = true;
+
+    // max tx power
+    if (buffer[4] != 0xFF) {
+        if ((version != 1) || ((version == 1) && (buffer[4] >= 10))) {
+            params->tx_power = (int8_t)buffer[4];
+            params->tx_power_valid = true;
+        }
+    }
+
+    // country code
+    if ((buffer[6] != 0xFF) && (buffer[7] != 0xFF) && (buffer[8] != 0xFF)) {
+        if ((buffer[6] < 1) || (buffer[7] > 14) || (buffer[7] < buffer[6])) {
+            ESP_AT_LOGE(TAG, "invalid country code, s:%d n:%d", buffer[6], buffer[7]);
+        } else {
+            params->country_schan = buffer[6];
+            params->country_nchan = buffer[7] - buffer[6] + 1;
+            memcpy(params->country_cc, &buffer[8], sizeof(params->country_cc));
+            params->country_valid = true;
+        }
+    }
+
+    // uart baudrate is stored in the 12nd to 15th bytes of the partition
+    if (buffer[12] != 0xFF || buffer[13] != 0xFF || buffer[14] != 0xFF || buffer[15] != 0xFF) {
+        memcpy(&params->uart_baudrate, &buffer[12], sizeof(params->uart_baudrate));
+        params->uart_baudrate_valid = true;
+    }
+
+    // uart port is stored in the 5th byte, uart pins are stored in the 16th to 19th bytes of the partition
+    params->uart_port = (buffer[5] != 0xFF) ? buffer[5] : -1;
+    if (buffer[16] != 0xFF && buffer[17] != 0xFF) {
+        params->uart_tx_pin = buffer[16];
+        params->uart_rx_pin = buffer[17];
+    }
+    params->uart_cts_pin = (buffer[18] != 0xFF) ? buffer[18] : -1;
+    params->uart_rts_pin = (buffer[19] != 0xFF) ? buffer[19] : -1;
+    params->uart_pins_valid = true;
+}
+
 at_mfg_params_storage_mode_t at_get_mfg_params_storage_mode(void)
 {
     return s_at_param_mode;
 }
 
+const at_mfg_params_t *at_get_mfg_params(void)
+{
+    return &s_at_mfg_params;
+}
+
 static void at_nvs_flash_init_partition(void)
 {
+    const esp_partition_t *param_partition = NULL;
     const esp_partition_t *partition = esp_at_custom_partition_find(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, g_at_mfg_nvs_name);
     if (partition) {
         if (nvs_flash_init_partition_ptr(partition) != ESP_OK) {
@@ -297,13 +383,29 @@ static void at_nvs_flash_init_partition(void)
         } else {
             s_at_param_mode = AT_PARAMS_IN_MFG_NVS;
         }
-    } else if (esp_at_custom_partition_find(0x40, 0xff, "factory_param")) {
+    } else if ((param_partition = esp_at_custom_partition_find(0x40, 0xff, "factory_param")) != NULL) {
         s_at_param_mode = AT_PARAMS_IN_PARTITION;
     } else {
         s_at_param_mode = AT_PARAMS_NONE;
     }
 
     ESP_AT_LOGI(TAG, "at param mode: %d", s_at_param_mode);
+
+    // decode all the factory parameters once, the later consumers only read the cached copy
+    memset(&s_at_mfg_params, 0x0, sizeof(s_at_mfg_params));
+    s_at_mfg_params.mode = s_at_param_mode;
+    s_at_mfg_params.uart_port = -1;
+    s_at_mfg_params.uart_tx_pin = -1;
+    s_at_mfg_params.uart_rx_pin = -1;
+    s_at_mfg_params.uart_cts_pin = -1;
+    s_at_mfg_params.uart_rts_pin = -1;
+    s_at_mfg_params.sys_tune.intf_task_core_id = -1;
+    if (s_at_param_mode == AT_PARAMS_IN_MFG_NVS) {
+        at_mfg_params_load_from_nvs(&s_at_mfg_params);
+        at_mfg_sys_tune_load_from_nvs(&s_at_mfg_params.sys_tune);
+    } else if (s_at_param_mode == AT_PARAMS_IN_PARTITION) {
+        at_mfg_params_load_from_partition(&s_at_mfg_params, param_partition);
+    }
 }
 
 static void esp_at_ready(void)
@@ -314,6 +416,11 @@ static void esp_at_ready(void)
 static IRAM_ATTR void at_alloc_failed_cb(size_t requested_size, uint32_t caps, const char *function_name)
 {
     esp_rom_printf(DRAM_STR(LOG_ANSI_COLOR_REGULAR(LOG_ANSI_COLOR_RED) "alloc failed, size:%u, caps:0x%x" LOG_ANSI_COLOR_RESET "\n"), requested_size, caps);
+
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+    // keep the failure in a ring which survives a soft reset, and AT+SYSALLOCFAIL? reads it out
+    at_alloc_failed_record(requested_size, caps);
+#endif
 }
 
 #ifdef CONFIG_AT_DEBUG
@@ -347,6 +454,82 @@ static void at_ota_mark_app_valid_cancel_rollback(void)
 }
 #endif
 
+#ifdef CONFIG_AT_WIFI_COMMAND_SUPPORT
+static void at_wifi_driver_init(void)
+{
+    esp_netif_create_default_wifi_sta();
+    esp_netif_create_default_wifi_ap();
+    at_wifi_init();
+
+#ifdef CONFIG_AT_WIFI_DUMP_STATIS_DEBUG
+    xTaskCreate(at_wifi_statistics_task, "wifi-dbg", 2048, NULL, 1, NULL);
+#endif
+}
+
+static const at_boot_stage_t s_wifi_init_stage = {"wifi_init", at_wifi_driver_init, AT_BOOT_STAGE_WIFI_INIT_BIT};
+#endif
+
+#ifdef CONFIG_BT_ENABLED
+static const at_boot_stage_t s_bt_mem_release_stage = {"bt_mem_release", at_bt_controller_mem_release, AT_BOOT_STAGE_BT_MEM_RELEASE_BIT};
+#endif
+
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+static void at_boot_stage_task(void *params)
+{
+    const at_boot_stage_t *stage = (const at_boot_stage_t *)params;
+    int64_t start_us = esp_timer_get_time();
+    stage->fn();
+    int64_t end_us = esp_timer_get_time();
+    esp_at_boot_phase_record(stage->name, (uint32_t)start_us, (uint32_t)end_us);
+    ESP_LOGD(TAG, "%s done in %"PRId64" us", stage->name, end_us - start_us);
+
+    xEventGroupSetBits(s_boot_stage_done, stage->done_bit);
+    vTaskDelete(NULL);
+}
+#endif
+
+static void at_boot_stage_start(const at_boot_stage_t *stage)
+{
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+    // run the stage on another task (and another core if there is), and the caller continues with the next stage
+    if (s_boot_stage_done && xTaskCreatePinnedToCore(at_boot_stage_task, stage->name, AT_BOOT_STAGE_TASK_STACK_SIZE, (void *)stage,
+                                                     uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY) == pdPASS) {
+        return;
+    }
+    ESP_AT_LOGW(TAG, "%s runs in sequence", stage->name);
+#endif
+
+    esp_at_boot_phase_begin(stage->name);
+    stage->fn();
+
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+    if (s_boot_stage_done) {
+        xEventGroupSetBits(s_boot_stage_done, stage->done_bit);
+    }
+#endif
+}
+
+static void at_boot_stage_join(EventBits_t bits)
+{
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+    if (!s_boot_stage_done) {
+        return;
+    }
+    EventBits_t started = AT_BOOT_STAGE_ALL_BITS;
+#ifndef CONFIG_AT_WIFI_COMMAND_SUPPORT
+    started &= ~AT_BOOT_STAGE_WIFI_INIT_BIT;
+#endif
+#ifndef CONFIG_BT_ENABLED
+    started &= ~AT_BOOT_STAGE_BT_MEM_RELEASE_BIT;
+#endif
+    bits &= started;
+    if (bits && (xEventGroupGetBits(s_boot_stage_done) & bits) != bits) {
+        esp_at_boot_phase_begin("stage_join");
+        xEventGroupWaitBits(s_boot_stage_done, bits, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+#endif
+}
+
 void esp_at_init(void)
 {
     // set log level to max
@@ -361,39 +544,50 @@ void esp_at_init(void)
 #endif
 
     // initialize the manufacturing nvs partition
+    esp_at_boot_phase_begin("nvs_init");
     at_nvs_flash_init_partition();
 
-#ifdef CONFIG_AT_WIFI_COMMAND_SUPPORT
-    // initialize the interface for wifi station and softap
-    esp_netif_create_default_wifi_sta();
-    esp_netif_create_default_wifi_ap();
-    at_wifi_init();
+#ifdef CONFIG_AT_PARALLEL_BOOT_SUPPORT
+    s_boot_stage_done = xEventGroupCreate();
+#endif
 
-#ifdef CONFIG_AT_WIFI_DUMP_STATIS_DEBUG
-    xTaskCreate(at_wifi_statistics_task, "wifi-dbg", 2048, NULL, 1, NULL);
+#ifdef CONFIG_AT_WIFI_COMMAND_SUPPORT
+    // initialize the interface for wifi station and softap, and the wifi driver
+    at_boot_stage_start(&s_wifi_init_stage);
 #endif
+
+#if defined(CONFIG_BT_ENABLED) && defined(CONFIG_AT_PARALLEL_BOOT_SUPPORT)
+    // release possible memory allocated by the bt controller, in parallel with the stages up to the command registration
+    at_boot_stage_start(&s_bt_mem_release_stage);
 #endif
 
     // initialize the interface for esp-at and mcu communication
+    esp_at_boot_phase_begin("interface_init");
     at_interface_init();
 
     // initialize the module configuration based on the parameters in the manufacturing partition
+    esp_at_boot_phase_begin("module_config_init");
     at_module_config_init();
 
 #ifdef CONFIG_AT_WIFI_COMMAND_SUPPORT
     // initialize the wifi configuration based on the parameters in the manufacturing partition
+    at_boot_stage_join(s_wifi_init_stage.done_bit);
+    esp_at_boot_phase_begin("wifi_config_init");
     at_wifi_config_init();
 #endif
 
     // initialize the AT framework (init task, queue, at cmd parser, at cmd responder, etc)
+    esp_at_boot_phase_begin("module_init");
     at_module_init();
 
-    // register all the at command set
+    // register all the at command set, all the asynchronous stages should be done before that
+    at_boot_stage_join(AT_BOOT_STAGE_ALL_BITS);
+    esp_at_boot_phase_begin("cmd_set_register");
     esp_at_cmd_set_register();
 
-#ifdef CONFIG_BT_ENABLED
+#if defined(CONFIG_BT_ENABLED) && !defined(CONFIG_AT_PARALLEL_BOOT_SUPPORT)
     // release possible memory allocated by the bt controller
-    at_bt_controller_mem_release();
+    at_boot_stage_start(&s_bt_mem_release_stage);
 #endif
 
 #ifdef CONFIG_AT_COMMAND_TERMINATOR_SUPPORT
@@ -402,6 +596,7 @@ void esp_at_init(void)
 #endif
 
     // do some special things before AT is ready
+    esp_at_boot_phase_begin("ready_before");
     esp_at_ready_before();
 
 #if defined(CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) && !defined(CONFIG_BOOTLOADER_COMPRESSED_ENABLED)
@@ -410,8 +605,11 @@ void esp_at_init(void)
 #endif
 
     // once the interface is started, the AT command can be received and processed
+    esp_at_boot_phase_begin("interface_start");
     at_interface_start();
 
+    esp_at_boot_phase_begin("ready");
     esp_at_ready();
+    esp_at_boot_phase_end();
     ESP_LOGD(TAG, "esp_at_init done");
 }
@@ -0,0 +1,472 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+#include "esp_private/cache_utils.h"
+#endif
+#include "esp_at_core.h"
+#include "esp_at.h"
+
+#ifdef CONFIG_AT_SYSMON_COMMAND_SUPPORT
+#define AT_SYSMON_BUFFER_SIZE           96
+#define AT_SYSMON_TASK_NUM_MARGIN       4
+#define AT_SYSMON_INTERVAL_MAX          3600    // seconds
+#define AT_SYSMON_TASK_STACK_SIZE       3072
+#define AT_SYSMON_TASK_PRIORITY         1
+
+#define AT_SYSCPU_WINDOW_MIN            100     // milliseconds
+#define AT_SYSCPU_WINDOW_MAX            10000   // milliseconds
+#define AT_SYSCPU_TASK_STACK_SIZE       3072
+#define AT_SYSCPU_TASK_PRIORITY         1
+
+typedef struct {
+    const char *name;
+    uint32_t caps;
+} at_sysmon_heap_caps_t;
+
+static const at_sysmon_heap_caps_t s_sysmon_heap_caps[] = {
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"dma", MALLOC_CAP_DMA},
+#ifdef CONFIG_SPIRAM
+    {"spiram", MALLOC_CAP_SPIRAM},
+#endif
+};
+
+static TaskHandle_t s_sysmon_task;
+static uint32_t s_sysmon_interval;
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+#define AT_ALLOC_FAIL_RECORD_NUM        16
+#define AT_ALLOC_FAIL_RING_MAGIC        0x414c4643  // "ALFC"
+
+typedef struct {
+    uint32_t size;              /*!< requested size */
+    uint32_t caps;              /*!< requested capabilities */
+    uint32_t timestamp_ms;      /*!< time since boot */
+    uint32_t largest_free;      /*!< largest free block of the requested capabilities, 0 if unknown */
+    uint32_t boot_seq;          /*!< boot sequence number when the failure happens */
+    char task_name[12];         /*!< the task which requests the memory */
+} at_alloc_fail_record_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot_seq;
+    uint32_t head;              /*!< index of the next record to write */
+    uint32_t count;             /*!< number of valid records */
+    at_alloc_fail_record_t records[AT_ALLOC_FAIL_RECORD_NUM];
+} at_alloc_fail_ring_t;
+
+static RTC_NOINIT_ATTR at_alloc_fail_ring_t s_alloc_fail_ring;
+// a failure may be recorded on any task or in an interrupt while AT+SYSALLOCFAIL? reads out the ring
+static portMUX_TYPE s_alloc_fail_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+#ifdef CONFIG_AT_SYSCPU_COMMAND_SUPPORT
+static TaskHandle_t s_syscpu_task;
+// the settings are written by the AT task and read by the sampling task
+static portMUX_TYPE s_syscpu_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_syscpu_window_ms = 1000;      // window of the periodic sampling
+static uint32_t s_syscpu_interval;
+static uint32_t s_syscpu_oneshot_window_ms;     // window of the pending one-shot sampling, 0 if none
+#endif
+static const char *TAG = "at-sysmon";
+
+typedef int32_t (*at_sysmon_write_fn_t)(uint8_t *data, int32_t len);
+
+static void at_sysmon_report_heap(const char *cmd_name, at_sysmon_write_fn_t write_fn)
+{
+    uint8_t buffer[AT_SYSMON_BUFFER_SIZE] = {0};
+
+    for (int i = 0; i < sizeof(s_sysmon_heap_caps) / sizeof(s_sysmon_heap_caps[0]); i++) {
+        uint32_t caps = s_sysmon_heap_caps[i].caps;
+        int len = snprintf((char *)buffer, AT_SYSMON_BUFFER_SIZE, "%s:HEAP,\"%s\",%"PRIu32",%"PRIu32",%"PRIu32"\r\n", cmd_name, s_sysmon_heap_caps[i].name,
+                           (uint32_t)heap_caps_get_free_size(caps), (uint32_t)heap_caps_get_minimum_free_size(caps),
+                           (uint32_t)heap_caps_get_largest_free_block(caps));
+        write_fn(buffer, len);
+    }
+}
+
+static void at_sysmon_report_tasks(const char *cmd_name, at_sysmon_write_fn_t write_fn)
+{
+    uint8_t buffer[AT_SYSMON_BUFFER_SIZE] = {0};
+
+    // some tasks may be created between the two calls
+    UBaseType_t num = uxTaskGetNumberOfTasks() + AT_SYSMON_TASK_NUM_MARGIN;
+    TaskStatus_t *tasks = (TaskStatus_t *)malloc(num * sizeof(TaskStatus_t));
+    if (!tasks) {
+        ESP_AT_LOGE(TAG, "no memory for %u tasks", num);
+        return;
+    }
+    num = uxTaskGetSystemState(tasks, num, NULL);
+
+    for (UBaseType_t i = 0; i < num; i++) {
+        int len = snprintf((char *)buffer, AT_SYSMON_BUFFER_SIZE, "%s:TASK,\"%s\",%u,%u\r\n", cmd_name, tasks[i].pcTaskName,
+                           tasks[i].uxCurrentPriority, tasks[i].usStackHighWaterMark);
+        write_fn(buffer, len);
+    }
+    free(tasks);
+}
+
+// wait until the period elapses, or the task is notified of new settings, which restarts the period.
+// a zero period waits for the notification only
+static bool at_sysmon_wait_period(TickType_t *period_start, uint32_t period_ms)
+{
+    TickType_t period = pdMS_TO_TICKS(period_ms);
+    TickType_t wait = portMAX_DELAY;
+    if (period > 0) {
+        TickType_t elapsed = xTaskGetTickCount() - *period_start;
+        wait = (elapsed < period) ? (period - elapsed) : 0;
+    }
+
+    if (ulTaskNotifyTake(pdTRUE, wait) > 0) {
+        *period_start = xTaskGetTickCount();
+        return false;
+    }
+    *period_start += period;
+    return true;
+}
+
+// the reports write to the AT port and allocate memory, so they run on a task of their own rather than
+// on the esp_timer task. The task never exits, it blocks once the interval is 0
+static void at_sysmon_task(void *params)
+{
+    TickType_t period_start = xTaskGetTickCount();
+
+    while (1) {
+        if (at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000)) {
+            at_sysmon_report_heap("+SYSMON", esp_at_port_active_write_data);
+            at_sysmon_report_tasks("+SYSMON", esp_at_port_active_write_data);
+        }
+    }
+}
+
+static uint8_t at_query_cmd_sysmon(uint8_t *cmd_name)
+{
+    uint8_t buffer[AT_SYSMON_BUFFER_SIZE] = {0};
+    int len = snprintf((char *)buffer, AT_SYSMON_BUFFER_SIZE, "%s:%u\r\n", cmd_name, s_sysmon_interval);
+    esp_at_port_write_data(buffer, len);
+
+    at_sysmon_report_heap((const char *)cmd_name, esp_at_port_write_data);
+    at_sysmon_report_tasks((const char *)cmd_name, esp_at_port_write_data);
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_setup_cmd_sysmon(uint8_t para_num)
+{
+    int32_t interval = 0;
+    int32_t cnt = 0;
+
+    // interval in seconds, 0 to stop the periodic report
+    if (esp_at_get_para_as_digit(cnt++, &interval) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (interval < 0 || interval > AT_SYSMON_INTERVAL_MAX) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (cnt != para_num) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    if (interval > 0 && !s_sysmon_task) {
+        if (xTaskCreate(at_sysmon_task, "sysmon", AT_SYSMON_TASK_STACK_SIZE, NULL, AT_SYSMON_TASK_PRIORITY, &s_sysmon_task) != pdPASS) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    // the task restarts the period with the new interval
+    s_sysmon_interval = interval;
+    if (s_sysmon_task) {
+        xTaskNotifyGive(s_sysmon_task);
+    }
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+#ifdef CONFIG_AT_SYSCPU_COMMAND_SUPPORT
+static TaskStatus_t *at_syscpu_snapshot(UBaseType_t *num, configRUN_TIME_COUNTER_TYPE *total)
+{
+    UBaseType_t max = uxTaskGetNumberOfTasks() + AT_SYSMON_TASK_NUM_MARGIN;
+    TaskStatus_t *tasks = (TaskStatus_t *)malloc(max * sizeof(TaskStatus_t));
+    if (!tasks) {
+        return NULL;
+    }
+    *num = uxTaskGetSystemState(tasks, max, total);
+    return tasks;
+}
+
+// the run time of a task during the window, a task created in the window counts from zero
+static configRUN_TIME_COUNTER_TYPE at_syscpu_task_delta(const TaskStatus_t *prev, UBaseType_t prev_num, const TaskStatus_t *cur)
+{
+    for (UBaseType_t i = 0; i < prev_num; i++) {
+        // a task handle may be reused by a new task, so the task number is also checked
+        if (prev[i].xHandle == cur->xHandle && prev[i].xTaskNumber == cur->xTaskNumber) {
+            return cur->ulRunTimeCounter - prev[i].ulRunTimeCounter;
+        }
+    }
+    return cur->ulRunTimeCounter;
+}
+
+static bool at_syscpu_report(const char *cmd_name, uint32_t window_ms, at_sysmon_write_fn_t write_fn)
+{
+    uint8_t buffer[AT_SYSMON_BUFFER_SIZE] = {0};
+    UBaseType_t prev_num = 0, cur_num = 0;
+    configRUN_TIME_COUNTER_TYPE prev_total = 0, cur_total = 0;
+
+    TaskStatus_t *prev = at_syscpu_snapshot(&prev_num, &prev_total);
+    if (!prev) {
+        return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(window_ms));
+    TaskStatus_t *cur = at_syscpu_snapshot(&cur_num, &cur_total);
+    if (!cur) {
+        free(prev);
+        return false;
+    }
+
+    // the total run time is the elapsed time, each core contributes to it
+    uint64_t total_delta = (uint64_t)(cur_total - prev_total) * portNUM_PROCESSORS;
+    for (UBaseType_t i = 0; i < cur_num; i++) {
+        uint64_t delta = at_syscpu_task_delta(prev, prev_num, &cur[i]);
+        uint32_t permyriad = total_delta ? (uint32_t)(delta * 10000 / total_delta) : 0;
+        int len = snprintf((char *)buffer, AT_SYSMON_BUFFER_SIZE, "%s:\"%s\",%u.%02u,%u\r\n", cmd_name, cur[i].pcTaskName,
+                           permyriad / 100, permyriad % 100, (uint32_t)delta);
+        write_fn(buffer, len);
+    }
+
+    free(cur);
+    free(prev);
+    return true;
+}
+
+// one round of the sampling task: a pending one-shot sampling goes first, with its own window,
+// then the periodic sampling once its period elapses
+static void at_syscpu_poll(TickType_t *period_start)
+{
+    portENTER_CRITICAL(&s_syscpu_lock);
+    uint32_t oneshot_window_ms = s_syscpu_oneshot_window_ms;
+    uint32_t window_ms = s_syscpu_window_ms;
+    uint32_t interval = s_syscpu_interval;
+    s_syscpu_oneshot_window_ms = 0;
+    portEXIT_CRITICAL(&s_syscpu_lock);
+
+    if (oneshot_window_ms > 0) {
+        window_ms = oneshot_window_ms;
+    } else if (!at_sysmon_wait_period(period_start, interval * 1000)) {
+        return;
+    }
+
+    if (!at_syscpu_report("+SYSCPU", window_ms, esp_at_port_active_write_data)) {
+        ESP_AT_LOGE(TAG, "no memory for sampling");
+    }
+}
+
+// the task never exits, it blocks until it is notified once nothing is to be sampled
+static void at_syscpu_task(void *params)
+{
+    TickType_t period_start = xTaskGetTickCount();
+
+    while (1) {
+        at_syscpu_poll(&period_start);
+    }
+}
+
+static uint8_t at_query_cmd_syscpu(uint8_t *cmd_name)
+{
+    uint8_t buffer[AT_SYSMON_BUFFER_SIZE] = {0};
+
+    portENTER_CRITICAL(&s_syscpu_lock);
+    uint32_t window_ms = s_syscpu_window_ms;
+    uint32_t interval = s_syscpu_interval;
+    portEXIT_CRITICAL(&s_syscpu_lock);
+
+    int len = snprintf((char *)buffer, AT_SYSMON_BUFFER_SIZE, "%s:%u,%u\r\n", cmd_name, window_ms, interval);
+    esp_at_port_write_data(buffer, len);
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_setup_cmd_syscpu(uint8_t para_num)
+{
+    int32_t window_ms = 0, interval = 0;
+    int32_t cnt = 0;
+
+    // sampling window in milliseconds
+    if (esp_at_get_para_as_digit(cnt++, &window_ms) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (window_ms < AT_SYSCPU_WINDOW_MIN || window_ms > AT_SYSCPU_WINDOW_MAX) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    // report interval in seconds, optional
+    if (para_num > cnt) {
+        if (esp_at_get_para_as_digit(cnt++, &interval) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (interval < 0 || interval > AT_SYSMON_INTERVAL_MAX || (interval > 0 && interval * 1000 <= window_ms)) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+    if (cnt != para_num) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    // a one-shot sampling is also run by the task, so the AT task is not blocked during the window
+    if (!s_syscpu_task && (para_num == 1 || interval > 0)) {
+        if (xTaskCreate(at_syscpu_task, "syscpu", AT_SYSCPU_TASK_STACK_SIZE, NULL, AT_SYSCPU_TASK_PRIORITY, &s_syscpu_task) != pdPASS) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    bool busy = false;
+    portENTER_CRITICAL(&s_syscpu_lock);
+    if (para_num == 1) {
+        // the one-shot window does not change the window of the periodic sampling
+        busy = (s_syscpu_oneshot_window_ms > 0);
+        if (!busy) {
+            s_syscpu_oneshot_window_ms = window_ms;
+        }
+    } else {
+        s_syscpu_window_ms = window_ms;
+        s_syscpu_interval = interval;
+    }
+    portEXIT_CRITICAL(&s_syscpu_lock);
+    if (busy) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    // the task picks up the new settings, and restarts the period
+    if (s_syscpu_task) {
+        xTaskNotifyGive(s_syscpu_task);
+    }
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+#endif
+
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+// called with s_alloc_fail_lock held
+static void IRAM_ATTR at_alloc_fail_ring_check(void)
+{
+    // the ring survives a soft reset, and it is garbage after a power-on reset
+    if (s_alloc_fail_ring.magic != AT_ALLOC_FAIL_RING_MAGIC || s_alloc_fail_ring.head >= AT_ALLOC_FAIL_RECORD_NUM
+            || s_alloc_fail_ring.count > AT_ALLOC_FAIL_RECORD_NUM) {
+        memset(&s_alloc_fail_ring, 0x0, sizeof(s_alloc_fail_ring));
+        s_alloc_fail_ring.magic = AT_ALLOC_FAIL_RING_MAGIC;
+    }
+}
+
+// the allocation may fail while the flash cache is disabled, so this runs from IRAM,
+// and only calls the functions in flash once the cache is known to be enabled
+void IRAM_ATTR at_alloc_failed_record(size_t requested_size, uint32_t caps)
+{
+    bool in_isr = xPortInIsrContext();
+    bool flash_safe = !in_isr && spi_flash_cache_enabled();
+
+    // taken outside of the lock, the heap APIs take the heap lock
+    uint32_t largest_free = flash_safe ? heap_caps_get_largest_free_block(caps) : 0;
+    const char *task_name = in_isr ? DRAM_STR("ISR") : (flash_safe ? pcTaskGetName(NULL) : NULL);
+    uint32_t timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    portENTER_CRITICAL_SAFE(&s_alloc_fail_lock);
+    // an allocation may fail before the ring is initialized
+    at_alloc_fail_ring_check();
+
+    at_alloc_fail_record_t *record = &s_alloc_fail_ring.records[s_alloc_fail_ring.head];
+    record->size = requested_size;
+    record->caps = caps;
+    record->timestamp_ms = timestamp_ms;
+    record->largest_free = largest_free;
+    record->boot_seq = s_alloc_fail_ring.boot_seq;
+    // copied in place of strlcpy(), which is not in IRAM. The name is not NUL-terminated if it fills the field
+    uint32_t i = 0;
+    for (; task_name && task_name[i] && i < sizeof(record->task_name); i++) {
+        record->task_name[i] = task_name[i];
+    }
+    for (; i < sizeof(record->task_name); i++) {
+        record->task_name[i] = '\0';
+    }
+
+    s_alloc_fail_ring.head = (s_alloc_fail_ring.head + 1) % AT_ALLOC_FAIL_RECORD_NUM;
+    if (s_alloc_fail_ring.count < AT_ALLOC_FAIL_RECORD_NUM) {
+        s_alloc_fail_ring.count++;
+    }
+    portEXIT_CRITICAL_SAFE(&s_alloc_fail_lock);
+}
+
+static void at_alloc_fail_ring_init(void)
+{
+    portENTER_CRITICAL(&s_alloc_fail_lock);
+    at_alloc_fail_ring_check();
+    s_alloc_fail_ring.boot_seq++;
+    portEXIT_CRITICAL(&s_alloc_fail_lock);
+}
+
+static uint8_t at_query_cmd_sysallocfail(uint8_t *cmd_name)
+{
+    uint8_t buffer[AT_SYSMON_BUFFER_SIZE] = {0};
+    at_alloc_fail_record_t record;
+    uint32_t boot_seq = 0;
+
+    // read and clear from the oldest record to the latest one. Each record is taken out under the lock and
+    // printed outside of it, and the failures recorded meanwhile are read out as well
+    for (uint32_t n = 0; n < AT_ALLOC_FAIL_RECORD_NUM; n++) {
+        portENTER_CRITICAL(&s_alloc_fail_lock);
+        bool empty = (s_alloc_fail_ring.count == 0);
+        if (!empty) {
+            uint32_t oldest = (s_alloc_fail_ring.head + AT_ALLOC_FAIL_RECORD_NUM - s_alloc_fail_ring.count) % AT_ALLOC_FAIL_RECORD_NUM;
+            record = s_alloc_fail_ring.records[oldest];
+            s_alloc_fail_ring.count--;
+            boot_seq = s_alloc_fail_ring.boot_seq;
+        }
+        portEXIT_CRITICAL(&s_alloc_fail_lock);
+        if (empty) {
+            break;
+        }
+
+        int len = snprintf((char *)buffer, AT_SYSMON_BUFFER_SIZE, "%s:%d,%u,0x%x,\"%.*s\",%u,%u\r\n", cmd_name,
+                           (int)(boot_seq - record.boot_seq), record.size, record.caps,
+                           (int)sizeof(record.task_name), record.task_name, record.timestamp_ms, record.largest_free);
+        esp_at_port_write_data(buffer, len);
+    }
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+#endif
+
+static const esp_at_cmd_struct s_at_sysmon_cmd[] = {
+    {"+SYSMON", NULL, at_query_cmd_sysmon, at_setup_cmd_sysmon, NULL},
+#ifdef CONFIG_AT_SYSCPU_COMMAND_SUPPORT
+    {"+SYSCPU", NULL, at_query_cmd_syscpu, at_setup_cmd_syscpu, NULL},
+#endif
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+    {"+SYSALLOCFAIL", NULL, at_query_cmd_sysallocfail, NULL, NULL},
+#endif
+};
+
+bool esp_at_sysmon_cmd_regist(void)
+{
+#ifdef CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT
+    at_alloc_fail_ring_init();
+#endif
+
+    return esp_at_custom_cmd_array_regist(s_at_sysmon_cmd, sizeof(s_at_sysmon_cmd) / sizeof(s_at_sysmon_cmd[0]));
+}
+
+ESP_AT_CMD_SET_FIRST_INIT_FN(esp_at_sysmon_cmd_regist, 28);
+#endif
@@ -6,7 +6,9 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include "sdkconfig.h"
 
 #include "freertos/FreeRTOS.h"
@@ -22,15 +24,28 @@
 #include "at_compress_ota.h"
 #endif
 
+#include "esp_rom_crc.h"
+#include "rom/miniz.h"
+#include "mbedtls/sha256.h"
 #include "esp_http_client.h"
 #include "esp_https_ota.h"
+#include "esp_ota_ops.h"
 #include "esp_at_core.h"
 #include "esp_at.h"
 
 #ifdef CONFIG_AT_USER_COMMAND_SUPPORT
 
 #define AT_USERRAM_READ_BUFFER_SIZE     1024
+#define AT_USERRAM_POST_TIMEOUT_MS      10000
+#define AT_USERRAM_SHA256_LEN           32
 #define AT_USEROTA_URL_LEN_MAX          (8 * 1024)
+#define AT_USEROTA_CONNECTIONS_MAX      4
+#define AT_USEROTA_SEGMENT_SIZE         (64 * 1024)
+#define AT_USEROTA_SEGMENT_RETRY_MAX    3
+#define AT_USEROTA_BLOCK_SIZE           2048
+#define AT_USEROTA_TASK_STACK_SIZE      (6 * 1024)
+#define AT_USEROTA_TASK_PRIORITY        5
+#define AT_USEROTA_HTTP_PARTIAL_CONTENT 206
 #define AT_USERDOCS_BUFFER_LEN_MAX      (1024)
 #define AT_DOCS_SERVER_HOSTNAME         "docs.espressif.com"
 #define AT_DOCS_PROJECT_PATH            "projects/esp-at"
@@ -45,6 +60,13 @@ typedef enum {
     AT_USERRAM_WRITE,
     AT_USERRAM_READ,
     AT_USERRAM_CLEAR,
+    AT_USERRAM_POST,
+    AT_USERRAM_STREAM_READ,
+    AT_USERRAM_CRC32,
+    AT_USERRAM_SHA256,
+    AT_USERRAM_FILL,
+    AT_USERRAM_COPY,
+    AT_USERRAM_INFLATE,
     AT_USERRAM_MAX,
 } at_userram_op_t;
 
@@ -71,18 +93,31 @@ typedef struct {
     uint8_t wake_signal;
     uint32_t delay_ms;
     uint32_t check_mcu_awake;
+    uint8_t awake_number;
+    uint8_t awake_level;
 } at_wkmcu_cfg_t;
 
-static bool s_mcu_sleep;
+static volatile bool s_mcu_sleep;    // also written by the awake gpio isr
 static at_wkmcu_cfg_t s_wkmcu_cfg;
 static EventGroupHandle_t s_wkmcu_evt_group;
+static SemaphoreHandle_t s_wkmcu_mutex;
+static TaskHandle_t s_wkmcu_task;
+static at_write_data_fn_t s_wkmcu_write_fn;
+static volatile bool s_wkmcu_waking;
+static TaskHandle_t s_wkmcu_signal_task;
+static uint8_t *sp_wkmcu_buffer;
+static uint32_t s_wkmcu_buffer_len;
 
 #define AT_MCU_AWAKE_ON_MCU_SLEEP       BIT(CHECK_MCU_AWAKE_BY_MCU_SLP)
 #define AT_MCU_AWAKE_ON_AT_SLEEP        BIT(CHECK_MCU_AWAKE_BY_AT_SLP)
 #define AT_MCU_AWAKE_ON_TIMEO           BIT(CHECK_MCU_AWAKE_BY_TIMEO)
-#define AT_MCU_AWAKE_ON_GPIO            BIT(CHECK_MCU_AWAKE_BY_GPIO)    // unimplemented: check mcu awake state by gpio level
+#define AT_MCU_AWAKE_ON_GPIO            BIT(CHECK_MCU_AWAKE_BY_GPIO)
 #define AT_MCU_AWAKE_BIT                (AT_MCU_AWAKE_ON_MCU_SLEEP | AT_MCU_AWAKE_ON_AT_SLEEP | AT_MCU_AWAKE_ON_TIMEO | AT_MCU_AWAKE_ON_GPIO)
 #define AT_WKMCU_DELAY_MS_MAX           (60 * 1000) // 1 minute
+#define AT_WKMCU_REQUEST_BIT            BIT(8)      // the wake-up signal is sent, wait for the mcu
+#define AT_WKMCU_IDLE_BIT               BIT(9)      // no wake-up is in progress, nothing is buffered
+#define AT_WKMCU_TASK_STACK_SIZE        3072
+#define AT_WKMCU_TASK_PRIORITY          5
 #endif
 
 static uint8_t *sp_user_ram = NULL;
@@ -90,6 +125,18 @@ static uint32_t s_user_ram_size = 0;
 static int32_t s_user_ota_total_size = 0;
 static int32_t s_user_ota_recv_size = 0;
 static bool s_user_ota_is_chunked = true;
+
+typedef struct {
+    const char *url;
+    esp_ota_handle_t handle;
+    int32_t total_size;
+    int32_t segment_num;
+    int32_t next_segment;
+    int32_t downloaded_size;
+    bool failed;
+    SemaphoreHandle_t mutex;
+    SemaphoreHandle_t done_sema;
+} at_userota_parallel_t;
 static SemaphoreHandle_t s_at_user_sync_sema;
 static const char *TAG = "at-user";
 
@@ -98,10 +145,83 @@ static void at_user_wait_data_cb(void)
     xSemaphoreGive(s_at_user_sync_sema);
 }
 
+static esp_err_t at_userram_http_post(const char *url, const uint8_t *data, int32_t length, int *status_code)
+{
+    esp_http_client_config_t config = {
+        .url = url,
+        .method = HTTP_METHOD_POST,
+        .timeout_ms = AT_USERRAM_POST_TIMEOUT_MS,
+    };
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    if (!client) {
+        return ESP_FAIL;
+    }
+
+    // the body is sent straight out of user ram, no copy is made
+    esp_http_client_set_header(client, "Content-Type", "application/octet-stream");
+    esp_http_client_set_post_field(client, (const char *)data, length);
+
+    esp_err_t ret = esp_http_client_perform(client);
+    if (ret == ESP_OK) {
+        *status_code = esp_http_client_get_status_code(client);
+        ESP_AT_LOGI(TAG, "post %d bytes, status=%d", length, *status_code);
+    } else {
+        ESP_AT_LOGE(TAG, "post failed: %s", esp_err_to_name(ret));
+    }
+    esp_http_client_cleanup(client);
+
+    return ret;
+}
+
+static int32_t at_userram_port_write_all(uint8_t *data, int32_t length)
+{
+    int32_t had_written_len = 0, ret = 0;
+    while (had_written_len < length) {
+        ret = esp_at_port_write_data(data + had_written_len, length - had_written_len);
+        if (ret <= 0) {
+            break;
+        }
+        had_written_len += ret;
+    }
+
+    return had_written_len;
+}
+
+static bool at_userram_range_overlap(int32_t offset1, int32_t offset2, int32_t length1, int32_t length2)
+{
+    return (offset1 < offset2 + length2) && (offset2 < offset1 + length1);
+}
+
+static int32_t at_userram_inflate(const uint8_t *src, int32_t src_len, uint8_t *dst, int32_t dst_len)
+{
+    // tinfl_decompressor is about 11 KB, so it must not be placed on the AT process task stack
+    tinfl_decompressor *decomp = malloc(sizeof(tinfl_decompressor));
+    if (!decomp) {
+        return -1;
+    }
+    tinfl_init(decomp);
+
+    size_t in_bytes = src_len, out_bytes = dst_len;
+    tinfl_status status = tinfl_decompress(decomp, src, &in_bytes, dst, dst, &out_bytes,
+                                           TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+    free(decomp);
+
+    if (status != TINFL_STATUS_DONE) {
+        ESP_AT_LOGE(TAG, "inflate failed: %d", status);
+        return -1;
+    }
+
+    return out_bytes;
+}
+
 static uint8_t at_setup_cmd_userram(uint8_t para_num)
 {
 #define HEAD_BUFFER_SIZE    32
-    int32_t cnt = 0, operator = 0, length = 0, offset = 0;
+    int32_t cnt = 0, operator = 0, length = 0, offset = 0, crc = 0;
+    int32_t value = 0, dst_offset = 0, dst_length = 0;
+    uint32_t crc32 = 0;
+    uint8_t *url = NULL, *crc_str = NULL;
 
     // operator
     if (esp_at_get_para_as_digit(cnt++, &operator) != ESP_AT_PARA_PARSE_RESULT_OK) {
@@ -112,7 +232,7 @@ static uint8_t at_setup_cmd_userram(uint8_t para_num)
     }
 
     // length
-    if (operator == AT_USERRAM_MALLOC || operator == AT_USERRAM_WRITE || operator == AT_USERRAM_READ) {
+    if (operator != AT_USERRAM_FREE && operator != AT_USERRAM_CLEAR) {
         if (esp_at_get_para_as_digit(cnt++, &length) != ESP_AT_PARA_PARSE_RESULT_OK) {
             return ESP_AT_RESULT_CODE_ERROR;
         }
@@ -122,7 +242,7 @@ static uint8_t at_setup_cmd_userram(uint8_t para_num)
     }
 
     // offset
-    if (operator == AT_USERRAM_WRITE || operator == AT_USERRAM_READ) {
+    if (operator != AT_USERRAM_FREE && operator != AT_USERRAM_MALLOC && operator != AT_USERRAM_CLEAR) {
         if (cnt != para_num) {
             if (esp_at_get_para_as_digit(cnt++, &offset) == ESP_AT_PARA_PARSE_RESULT_FAIL) {
                 return ESP_AT_RESULT_CODE_ERROR;
@@ -133,6 +253,75 @@ static uint8_t at_setup_cmd_userram(uint8_t para_num)
         }
     }
 
+    // crc32 trailer
+    if (operator == AT_USERRAM_STREAM_READ) {
+        if (cnt != para_num) {
+            if (esp_at_get_para_as_digit(cnt++, &crc) != ESP_AT_PARA_PARSE_RESULT_OK) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            if (crc < 0 || crc > 1) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        }
+    }
+
+    // initial crc32, used to continue the crc32 of the previous range
+    if (operator == AT_USERRAM_CRC32) {
+        if (cnt != para_num) {
+            if (esp_at_get_para_as_str(cnt++, &crc_str) != ESP_AT_PARA_PARSE_RESULT_OK) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            char *endptr = NULL;
+            crc32 = strtoul((const char *)crc_str, &endptr, 16);
+            if (at_str_is_null(crc_str) || *endptr != '\0') {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        }
+    }
+
+    // fill value
+    if (operator == AT_USERRAM_FILL) {
+        if (esp_at_get_para_as_digit(cnt++, &value) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (value < 0 || value > 0xFF) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    // destination offset and length
+    if (operator == AT_USERRAM_COPY || operator == AT_USERRAM_INFLATE) {
+        if (esp_at_get_para_as_digit(cnt++, &dst_offset) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (dst_offset < 0) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        dst_length = length;
+    }
+    if (operator == AT_USERRAM_INFLATE) {
+        if (cnt != para_num) {
+            if (esp_at_get_para_as_digit(cnt++, &dst_length) != ESP_AT_PARA_PARSE_RESULT_OK) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            if (dst_length <= 0) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        } else {
+            dst_length = s_user_ram_size > dst_offset ? s_user_ram_size - dst_offset : 0;
+        }
+    }
+
+    // url
+    if (operator == AT_USERRAM_POST) {
+        if (esp_at_get_para_as_str(cnt++, &url) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (at_str_is_null(url)) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
     // parameters are ready
     if (cnt != para_num) {
         return ESP_AT_RESULT_CODE_ERROR;
@@ -235,6 +424,137 @@ static uint8_t at_setup_cmd_userram(uint8_t para_num)
         memset(sp_user_ram, 0x0, s_user_ram_size);
         break;
 
+    // post
+    case AT_USERRAM_POST: {
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        int status_code = 0;
+        if (at_userram_http_post((const char *)url, sp_user_ram + offset, length, &status_code) != ESP_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        uint8_t buffer[HEAD_BUFFER_SIZE] = {0};
+        snprintf((char *)buffer, HEAD_BUFFER_SIZE, "%s:%d\r\n", esp_at_get_current_cmd_name(), status_code);
+        esp_at_port_write_data(buffer, strlen((char *)buffer));
+        break;
+    }
+
+    // stream read
+    case AT_USERRAM_STREAM_READ: {
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        ESP_AT_LOGI(TAG, "to stream %d bytes", length);
+
+        // one header for the whole region, then the raw bytes straight from user ram
+        uint8_t buffer[HEAD_BUFFER_SIZE] = {0};
+        int32_t head_len = snprintf((char *)buffer, HEAD_BUFFER_SIZE, "%s:%d,", esp_at_get_current_cmd_name(), length);
+        esp_at_port_write_data(buffer, head_len);
+        if (at_userram_port_write_all(sp_user_ram + offset, length) != length) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        if (crc) {
+            crc32 = esp_rom_crc32_le(0, sp_user_ram + offset, length);
+            head_len = snprintf((char *)buffer, HEAD_BUFFER_SIZE, ",%08" PRIx32, crc32);
+            esp_at_port_write_data(buffer, head_len);
+        }
+        break;
+    }
+
+    // crc32
+    case AT_USERRAM_CRC32: {
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        uint8_t buffer[HEAD_BUFFER_SIZE] = {0};
+        crc32 = esp_rom_crc32_le(crc32, sp_user_ram + offset, length);
+        snprintf((char *)buffer, HEAD_BUFFER_SIZE, "%s:%08" PRIx32 "\r\n", esp_at_get_current_cmd_name(), crc32);
+        esp_at_port_write_data(buffer, strlen((char *)buffer));
+        break;
+    }
+
+    // sha256, done by the hardware sha accelerator if mbedtls is configured to use it
+    case AT_USERRAM_SHA256: {
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        uint8_t digest[AT_USERRAM_SHA256_LEN] = {0};
+        if (mbedtls_sha256(sp_user_ram + offset, length, digest, 0) != 0) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        uint8_t buffer[HEAD_BUFFER_SIZE + AT_USERRAM_SHA256_LEN * 2] = {0};
+        int32_t head_len = snprintf((char *)buffer, sizeof(buffer), "%s:", esp_at_get_current_cmd_name());
+        for (int i = 0; i < AT_USERRAM_SHA256_LEN; ++i) {
+            head_len += snprintf((char *)buffer + head_len, sizeof(buffer) - head_len, "%02x", digest[i]);
+        }
+        head_len += snprintf((char *)buffer + head_len, sizeof(buffer) - head_len, "\r\n");
+        esp_at_port_write_data(buffer, head_len);
+        break;
+    }
+
+    // fill
+    case AT_USERRAM_FILL:
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        memset(sp_user_ram + offset, value, length);
+        break;
+
+    // copy, the source and destination ranges are allowed to overlap
+    case AT_USERRAM_COPY:
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size || dst_offset + dst_length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        memmove(sp_user_ram + dst_offset, sp_user_ram + offset, length);
+        break;
+
+    // inflate a zlib stream into another range
+    case AT_USERRAM_INFLATE: {
+        if (sp_user_ram == NULL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (offset + length > s_user_ram_size || dst_length <= 0 || dst_offset + dst_length > s_user_ram_size) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (at_userram_range_overlap(offset, dst_offset, length, dst_length)) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        int32_t out_len = at_userram_inflate(sp_user_ram + offset, length, sp_user_ram + dst_offset, dst_length);
+        if (out_len < 0) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+
+        uint8_t buffer[HEAD_BUFFER_SIZE] = {0};
+        snprintf((char *)buffer, HEAD_BUFFER_SIZE, "%s:%d\r\n", esp_at_get_current_cmd_name(), out_len);
+        esp_at_port_write_data(buffer, strlen((char *)buffer));
+        break;
+    }
+
     default:
         return ESP_AT_RESULT_CODE_ERROR;
     }
@@ -297,11 +617,246 @@ static esp_err_t _http_event_handler(esp_http_client_event_t *evt)
     return ESP_OK;
 }
 
+static esp_err_t at_userota_range_header_handler(esp_http_client_event_t *evt)
+{
+    // Content-Range: bytes <start>-<end>/<total size>
+    if (evt->event_id == HTTP_EVENT_ON_HEADER && strcasecmp(evt->header_key, "Content-Range") == 0) {
+        char *total = strrchr(evt->header_value, '/');
+        if (total && *(total + 1) != '*') {
+            *(int32_t *)evt->user_data = atoi(total + 1);
+        }
+    }
+
+    return ESP_OK;
+}
+
+static int32_t at_userota_get_range_size(const char *url)
+{
+    int32_t total_size = -1;
+    esp_http_client_config_t config = {
+        .url = url,
+        .event_handler = at_userota_range_header_handler,
+        .user_data = &total_size,
+        .timeout_ms = 10000,
+    };
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    if (!client) {
+        return -1;
+    }
+
+    // a one-byte range request tells both the image size and whether the server supports ranges
+    esp_http_client_set_header(client, "Range", "bytes=0-0");
+    if (esp_http_client_open(client, 0) != ESP_OK || esp_http_client_fetch_headers(client) < 0
+            || esp_http_client_get_status_code(client) != AT_USEROTA_HTTP_PARTIAL_CONTENT) {
+        total_size = -1;
+    }
+
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+
+    return total_size;
+}
+
+// the shared state of the workers is only accessed under ota->mutex
+static void at_userota_set_failed(at_userota_parallel_t *ota)
+{
+    xSemaphoreTake(ota->mutex, portMAX_DELAY);
+    ota->failed = true;
+    xSemaphoreGive(ota->mutex);
+}
+
+static bool at_userota_is_failed(at_userota_parallel_t *ota)
+{
+    xSemaphoreTake(ota->mutex, portMAX_DELAY);
+    bool failed = ota->failed;
+    xSemaphoreGive(ota->mutex);
+    return failed;
+}
+
+static esp_err_t at_userota_fetch_range(esp_http_client_handle_t client, at_userota_parallel_t *ota, uint8_t *block, int32_t *offset, int32_t end)
+{
+    char range[32];
+    snprintf(range, sizeof(range), "bytes=%d-%d", *offset, end - 1);
+    esp_http_client_set_header(client, "Range", range);
+
+    esp_err_t ret = esp_http_client_open(client, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (esp_http_client_fetch_headers(client) < 0 || esp_http_client_get_status_code(client) != AT_USEROTA_HTTP_PARTIAL_CONTENT) {
+        esp_http_client_close(client);
+        return ESP_FAIL;
+    }
+
+    // write in whole blocks, so a retry can resume from the last written block
+    int32_t block_len = 0;
+    while (*offset < end) {
+        int len = esp_http_client_read(client, (char *)block + block_len, at_min(AT_USEROTA_BLOCK_SIZE - block_len, end - *offset - block_len));
+        if (len <= 0) {
+            ret = ESP_FAIL;
+            break;
+        }
+        block_len += len;
+
+        if (block_len == AT_USEROTA_BLOCK_SIZE || *offset + block_len == end) {
+            xSemaphoreTake(ota->mutex, portMAX_DELAY);
+            ret = esp_ota_write_with_offset(ota->handle, block, block_len, *offset);
+            if (ret == ESP_OK) {
+                ota->downloaded_size += block_len;
+            }
+            xSemaphoreGive(ota->mutex);
+            if (ret != ESP_OK) {
+                break;
+            }
+            *offset += block_len;
+            block_len = 0;
+        }
+    }
+
+    if (ret != ESP_OK) {
+        esp_http_client_close(client);
+    }
+
+    return ret;
+}
+
+static void at_userota_parallel_task(void *params)
+{
+    at_userota_parallel_t *ota = (at_userota_parallel_t *)params;
+    esp_http_client_config_t config = {
+        .url = ota->url,
+        .keep_alive_enable = true,
+        .timeout_ms = 10000,
+        .buffer_size = AT_USEROTA_BLOCK_SIZE,
+    };
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    uint8_t *block = malloc(AT_USEROTA_BLOCK_SIZE);
+    if (!client || !block) {
+        at_userota_set_failed(ota);
+        goto exit;
+    }
+
+    for (;;) {
+        xSemaphoreTake(ota->mutex, portMAX_DELAY);
+        int32_t segment = ota->next_segment++;
+        bool done = ota->failed || segment >= ota->segment_num;
+        xSemaphoreGive(ota->mutex);
+        if (done) {
+            break;
+        }
+
+        int32_t offset = segment * AT_USEROTA_SEGMENT_SIZE;
+        int32_t end = at_min(offset + AT_USEROTA_SEGMENT_SIZE, ota->total_size);
+        esp_err_t ret = ESP_FAIL;
+        for (int32_t retry = 0; retry <= AT_USEROTA_SEGMENT_RETRY_MAX && !at_userota_is_failed(ota); retry++) {
+            ret = at_userota_fetch_range(client, ota, block, &offset, end);
+            if (ret == ESP_OK) {
+                break;
+            }
+            ESP_AT_LOGW(TAG, "segment %d failed at %d (0x%x), retry: %d", segment, offset, ret, retry);
+        }
+        if (ret != ESP_OK) {
+            at_userota_set_failed(ota);
+            break;
+        }
+
+        // progress report
+        xSemaphoreTake(ota->mutex, portMAX_DELAY);
+        int32_t downloaded_size = ota->downloaded_size;
+        xSemaphoreGive(ota->mutex);
+        char report[48];
+        int report_len = snprintf(report, sizeof(report), "+USEROTA:%d,%d\r\n", downloaded_size, ota->total_size);
+        esp_at_port_active_write_data((uint8_t *)report, report_len);
+    }
+
+exit:
+    free(block);
+    if (client) {
+        esp_http_client_cleanup(client);
+    }
+    xSemaphoreGive(ota->done_sema);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t at_userota_parallel(const char *url, int32_t connections)
+{
+    int32_t total_size = at_userota_get_range_size(url);
+    if (total_size <= 0) {
+        ESP_AT_LOGW(TAG, "range request is not supported");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+    if (!partition || total_size > partition->size) {
+        ESP_AT_LOGE(TAG, "invalid image size: %d", total_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    at_userota_parallel_t ota = {
+        .url = url,
+        .total_size = total_size,
+        .segment_num = (total_size + AT_USEROTA_SEGMENT_SIZE - 1) / AT_USEROTA_SEGMENT_SIZE,
+    };
+    esp_err_t ret = ESP_OK;
+    connections = at_min(connections, ota.segment_num);
+    ota.mutex = xSemaphoreCreateMutex();
+    ota.done_sema = xSemaphoreCreateCounting(connections, 0);
+    if (!ota.mutex || !ota.done_sema) {
+        ret = ESP_ERR_NO_MEM;
+        goto exit;
+    }
+
+    // erase the required size at once, the segments are written at their offsets in any order
+    ret = esp_ota_begin(partition, total_size, &ota.handle);
+    if (ret != ESP_OK) {
+        ESP_AT_LOGE(TAG, "esp_ota_begin failed: 0x%x", ret);
+        goto exit;
+    }
+
+    ESP_AT_LOGI(TAG, "download %d bytes in %d segments over %d connections", total_size, ota.segment_num, connections);
+    int32_t created = 0;
+    for (; created < connections; created++) {
+        if (xTaskCreate(at_userota_parallel_task, "userota", AT_USEROTA_TASK_STACK_SIZE, &ota, AT_USEROTA_TASK_PRIORITY, NULL) != pdPASS) {
+            break;
+        }
+    }
+    for (int32_t i = 0; i < created; i++) {
+        xSemaphoreTake(ota.done_sema, portMAX_DELAY);
+    }
+
+    // all the workers have exited, the state can be read without the lock
+    if (created == 0 || ota.failed || ota.downloaded_size != total_size) {
+        esp_ota_abort(ota.handle);
+        ret = ESP_FAIL;
+        goto exit;
+    }
+
+    ret = esp_ota_end(ota.handle);
+    if (ret != ESP_OK) {
+        ESP_AT_LOGE(TAG, "esp_ota_end failed: 0x%x", ret);
+        goto exit;
+    }
+    ret = esp_ota_set_boot_partition(partition);
+
+exit:
+    if (ota.mutex) {
+        vSemaphoreDelete(ota.mutex);
+    }
+    if (ota.done_sema) {
+        vSemaphoreDelete(ota.done_sema);
+    }
+
+    return ret;
+}
+
 static uint8_t at_setup_cmd_userota(uint8_t para_num)
 {
 #define TEMP_BUFFER_SIZE    32
     uint8_t buffer[TEMP_BUFFER_SIZE] = {0};
     int32_t length = 0;
+    int32_t connections = 1;
     int32_t cnt = 0;
 
     // length
@@ -312,6 +867,16 @@ static uint8_t at_setup_cmd_userota(uint8_t para_num)
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
+    // connections
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &connections) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if ((connections <= 0) || (connections > AT_USEROTA_CONNECTIONS_MAX)) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
     // parameters are ready
     if (cnt != para_num) {
         return ESP_AT_RESULT_CODE_ERROR;
@@ -372,11 +937,19 @@ static uint8_t at_setup_cmd_userota(uint8_t para_num)
 #if defined(CONFIG_BOOTLOADER_COMPRESSED_ENABLED) && defined(CONFIG_ENABLE_LEGACY_ESP_BOOTLOADER_PLUS_V2_SUPPORT)
     esp_err_t ret = at_compress_https_ota(&config);
 #else
-    esp_https_ota_config_t ota_config = {
-        .http_config = &config,
-    };
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+    if (connections > 1) {
+        ret = at_userota_parallel((const char *)url, connections);
+    }
+
+    // fall back to a single stream if the server does not support range requests
+    if (ret == ESP_ERR_NOT_SUPPORTED) {
+        esp_https_ota_config_t ota_config = {
+            .http_config = &config,
+        };
 
-    esp_err_t ret = esp_https_ota(&ota_config);
+        ret = esp_https_ota(&ota_config);
+    }
 #endif
 
     free(url);
@@ -416,6 +989,71 @@ static uint8_t at_query_cmd_userdocs(uint8_t *cmd_name)
 }
 
 #ifdef CONFIG_AT_USERWKMCU_COMMAND_SUPPORT
+static void at_mcu_awake_gpio_isr_handler(void *arg)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
+    if (gpio_get_level(s_wkmcu_cfg.awake_number) == s_wkmcu_cfg.awake_level) {
+        s_mcu_sleep = false;
+        xEventGroupSetBitsFromISR(s_wkmcu_evt_group, AT_MCU_AWAKE_ON_GPIO, &higher_priority_task_woken);
+    } else {
+        xEventGroupClearBitsFromISR(s_wkmcu_evt_group, AT_MCU_AWAKE_BIT);
+        s_mcu_sleep = true;
+    }
+
+    if (higher_priority_task_woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static esp_err_t at_mcu_awake_gpio_config(uint8_t gpio_num, uint8_t level)
+{
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = (1ULL << gpio_num);
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = false;
+    io_conf.pull_down_en = false;
+    io_conf.intr_type = GPIO_INTR_ANYEDGE;
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // the isr service may have been installed by others
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return ret;
+    }
+
+    return gpio_isr_handler_add(gpio_num, at_mcu_awake_gpio_isr_handler, NULL);
+}
+
+static void at_mcu_awake_gpio_deconfig(uint8_t gpio_num)
+{
+    gpio_isr_handler_remove(gpio_num);
+
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = (1ULL << gpio_num);
+    io_conf.mode = GPIO_MODE_DISABLE;
+    io_conf.pull_up_en = false;
+    io_conf.pull_down_en = false;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    gpio_config(&io_conf);
+}
+
+static void at_wkmcu_wake_gpio_deconfig(uint8_t gpio_num)
+{
+    gpio_hold_dis(gpio_num);
+
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = (1ULL << gpio_num);
+    io_conf.mode = GPIO_MODE_DISABLE;
+    io_conf.pull_up_en = false;
+    io_conf.pull_down_en = false;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    gpio_config(&io_conf);
+}
+
 void at_set_mcu_state_if_sleep(at_sleep_mode_t mode)
 {
     if (!(s_wkmcu_cfg.check_mcu_awake & AT_MCU_AWAKE_ON_AT_SLEEP)) {
@@ -442,12 +1080,69 @@ void at_set_mcu_state_if_sleep(at_sleep_mode_t mode)
     return;
 }
 
+static void at_wkmcu_task(void *params)
+{
+    for (;;) {
+        xEventGroupWaitBits(s_wkmcu_evt_group, AT_WKMCU_REQUEST_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+
+        ESP_AT_LOGI(TAG, "wait %ums or wake-up signal", s_wkmcu_cfg.delay_ms);
+        EventBits_t uxBits = 0;
+        if (s_wkmcu_cfg.check_mcu_awake) {
+            uxBits = xEventGroupWaitBits(s_wkmcu_evt_group, s_wkmcu_cfg.check_mcu_awake, pdFALSE, pdFALSE, s_wkmcu_cfg.delay_ms / portTICK_PERIOD_MS);
+        } else {
+            vTaskDelay(s_wkmcu_cfg.delay_ms / portTICK_PERIOD_MS);
+        }
+
+        if (!(uxBits & s_wkmcu_cfg.check_mcu_awake)) {
+            // timeout
+            if (s_wkmcu_cfg.check_mcu_awake & AT_MCU_AWAKE_ON_TIMEO) {
+                xEventGroupSetBits(s_wkmcu_evt_group, AT_MCU_AWAKE_ON_TIMEO);
+                s_mcu_sleep = false;
+            } else {
+                xEventGroupClearBits(s_wkmcu_evt_group, AT_MCU_AWAKE_BIT);
+                s_mcu_sleep = true;
+            }
+        }
+
+        // reverse wake up signal
+        if (s_wkmcu_cfg.wake_mode == WKMCU_MODE_GPIO) {
+            gpio_hold_dis(s_wkmcu_cfg.wake_number);
+            gpio_set_level(s_wkmcu_cfg.wake_number, !s_wkmcu_cfg.wake_signal);
+            gpio_hold_en(s_wkmcu_cfg.wake_number);
+        }
+
+        // flush all the data buffered during the wake-up in one burst
+        xSemaphoreTake(s_wkmcu_mutex, portMAX_DELAY);
+        if (s_wkmcu_buffer_len > 0) {
+            ESP_AT_LOGI(TAG, "flush %u bytes", s_wkmcu_buffer_len);
+            s_wkmcu_write_fn(sp_wkmcu_buffer, s_wkmcu_buffer_len);
+            s_wkmcu_buffer_len = 0;
+        }
+        s_wkmcu_waking = false;
+        xEventGroupSetBits(s_wkmcu_evt_group, AT_WKMCU_IDLE_BIT);
+        xSemaphoreGive(s_wkmcu_mutex);
+    }
+}
+
 void at_wkmcu_if_config(at_write_data_fn_t write_data_fn)
 {
     if (!s_wkmcu_cfg.enable || !s_mcu_sleep) {
         return;
     }
 
+    // check and set under the mutex so that only one writer sends the wake-up signal,
+    // the data written after it will be buffered until the mcu is awake
+    xSemaphoreTake(s_wkmcu_mutex, portMAX_DELAY);
+    if (s_wkmcu_waking) {
+        xSemaphoreGive(s_wkmcu_mutex);
+        return;
+    }
+    s_wkmcu_write_fn = write_data_fn;
+    s_wkmcu_waking = true;
+    s_wkmcu_signal_task = xTaskGetCurrentTaskHandle();
+    xEventGroupClearBits(s_wkmcu_evt_group, AT_WKMCU_IDLE_BIT);
+    xSemaphoreGive(s_wkmcu_mutex);
+
     switch (s_wkmcu_cfg.wake_mode) {
     case WKMCU_MODE_GPIO:
         gpio_hold_dis(s_wkmcu_cfg.wake_number);
@@ -462,34 +1157,46 @@ void at_wkmcu_if_config(at_write_data_fn_t write_data_fn)
     default:
         break;
     }
+    s_wkmcu_signal_task = NULL;
 
-    ESP_AT_LOGI(TAG, "wait %ums or wake-up signal", s_wkmcu_cfg.delay_ms);
-    EventBits_t uxBits = xEventGroupWaitBits(s_wkmcu_evt_group, s_wkmcu_cfg.check_mcu_awake, pdFALSE, pdFALSE, s_wkmcu_cfg.delay_ms / portTICK_PERIOD_MS);
+    // the wake-up task waits for the mcu instead of the writer
+    xEventGroupSetBits(s_wkmcu_evt_group, AT_WKMCU_REQUEST_BIT);
 
-    if (!(uxBits & s_wkmcu_cfg.check_mcu_awake)) {
-        // timeout
-        if (s_wkmcu_cfg.check_mcu_awake & AT_MCU_AWAKE_ON_TIMEO) {
-            xEventGroupSetBits(s_wkmcu_evt_group, AT_MCU_AWAKE_ON_TIMEO);
-            s_mcu_sleep = false;
-        } else {
-            xEventGroupClearBits(s_wkmcu_evt_group, AT_MCU_AWAKE_BIT);
-            s_mcu_sleep = true;
-        }
+    return;
+}
+
+bool at_wkmcu_write_if_waking(uint8_t *data, int32_t len)
+{
+    // the wake-up signal itself and the flush from the wake-up task are never buffered
+    TaskHandle_t cur_task = xTaskGetCurrentTaskHandle();
+    if (!s_wkmcu_waking || cur_task == s_wkmcu_task || cur_task == s_wkmcu_signal_task) {
+        return false;
     }
 
-    // reverse wake up signal
-    if (s_wkmcu_cfg.wake_mode == WKMCU_MODE_GPIO) {
-        gpio_hold_dis(s_wkmcu_cfg.wake_number);
-        gpio_set_level(s_wkmcu_cfg.wake_number, !s_wkmcu_cfg.wake_signal);
-        gpio_hold_en(s_wkmcu_cfg.wake_number);
+    xSemaphoreTake(s_wkmcu_mutex, portMAX_DELAY);
+    while (s_wkmcu_waking && s_wkmcu_buffer_len + len > CONFIG_AT_USERWKMCU_BUFFER_SIZE) {
+        // buffer is full, wait until the buffered data is flushed
+        xSemaphoreGive(s_wkmcu_mutex);
+        xEventGroupWaitBits(s_wkmcu_evt_group, AT_WKMCU_IDLE_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
+        xSemaphoreTake(s_wkmcu_mutex, portMAX_DELAY);
     }
 
-    return;
+    if (!s_wkmcu_waking) {
+        xSemaphoreGive(s_wkmcu_mutex);
+        return false;
+    }
+
+    memcpy(sp_wkmcu_buffer + s_wkmcu_buffer_len, data, len);
+    s_wkmcu_buffer_len += len;
+    xSemaphoreGive(s_wkmcu_mutex);
+
+    return true;
 }
 
 static uint8_t at_setup_cmd_userwkmcucfg(uint8_t para_num)
 {
     int32_t cnt = 0, enable = 0, wk_mode = 0, wk_number = 0, wk_signal = 0, delay_ms = 0, check_awake = 0;
+    int32_t awake_number = 0, awake_level = 0;
 
     if (s_mcu_sleep == true) {
         return ESP_AT_RESULT_CODE_ERROR;
@@ -563,9 +1270,28 @@ static uint8_t at_setup_cmd_userwkmcucfg(uint8_t para_num)
         } else {
             check_awake = BIT(CHECK_MCU_AWAKE_BY_MCU_SLP);
         }
-        if (check_awake < 0 || check_awake >= BIT(CHECK_MCU_AWAKE_BY_GPIO)) {
+        if (check_awake < 0 || check_awake >= BIT(CHECK_MCU_AWAKE_BY_MAX)) {
             return ESP_AT_RESULT_CODE_ERROR;
         }
+
+        // awake gpio and awake level, only for checking mcu awake state by gpio level
+        if (check_awake & AT_MCU_AWAKE_ON_GPIO) {
+            if (esp_at_get_para_as_digit(cnt++, &awake_number) != ESP_AT_PARA_PARSE_RESULT_OK) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            if (!GPIO_IS_VALID_GPIO(awake_number)) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            if (wk_mode == WKMCU_MODE_GPIO && awake_number == wk_number) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            if (esp_at_get_para_as_digit(cnt++, &awake_level) != ESP_AT_PARA_PARSE_RESULT_OK) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+            if (awake_level < 0 || awake_level > 1) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        }
     } else {
         // already disabled
         if (s_wkmcu_cfg.enable == 0) {
@@ -578,6 +1304,29 @@ static uint8_t at_setup_cmd_userwkmcucfg(uint8_t para_num)
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
+    // prepare the wake-up task and the buffer for the data sent during the wake-up
+    if (enable) {
+        if (!s_wkmcu_task) {
+            if (xTaskCreate(at_wkmcu_task, "wkmcu", AT_WKMCU_TASK_STACK_SIZE, NULL, AT_WKMCU_TASK_PRIORITY, &s_wkmcu_task) != pdPASS) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        }
+        if (!sp_wkmcu_buffer) {
+            sp_wkmcu_buffer = malloc(CONFIG_AT_USERWKMCU_BUFFER_SIZE);
+            if (!sp_wkmcu_buffer) {
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        }
+    } else {
+        xEventGroupWaitBits(s_wkmcu_evt_group, AT_WKMCU_IDLE_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
+    }
+
+    // the previous awake gpio keeps its isr until it is removed here
+    if (s_wkmcu_cfg.check_mcu_awake & AT_MCU_AWAKE_ON_GPIO) {
+        at_mcu_awake_gpio_deconfig(s_wkmcu_cfg.awake_number);
+        s_wkmcu_cfg.check_mcu_awake &= ~AT_MCU_AWAKE_ON_GPIO;
+    }
+
     // preset gpio status
     if (enable) {
         if (wk_mode == WKMCU_MODE_GPIO) {
@@ -592,15 +1341,22 @@ static uint8_t at_setup_cmd_userwkmcucfg(uint8_t para_num)
             gpio_set_level(wk_number, !wk_signal);
             gpio_hold_en(wk_number);
         }
+        if (check_awake & AT_MCU_AWAKE_ON_GPIO) {
+            s_wkmcu_cfg.awake_number = awake_number;
+            s_wkmcu_cfg.awake_level = awake_level;
+            if (at_mcu_awake_gpio_config(awake_number, awake_level) != ESP_OK) {
+                ESP_AT_LOGE(TAG, "awake gpio%d config failed", awake_number);
+                // release the pins set up above, the config stays disabled
+                at_mcu_awake_gpio_deconfig(awake_number);
+                if (wk_mode == WKMCU_MODE_GPIO) {
+                    at_wkmcu_wake_gpio_deconfig(wk_number);
+                }
+                return ESP_AT_RESULT_CODE_ERROR;
+            }
+        }
     } else {
         if (s_wkmcu_cfg.wake_mode == WKMCU_MODE_GPIO) {
-            gpio_config_t io_conf;
-            io_conf.pin_bit_mask = (1ULL << s_wkmcu_cfg.wake_number);
-            io_conf.mode = GPIO_MODE_DISABLE;
-            io_conf.pull_up_en = false;
-            io_conf.pull_down_en = false;
-            io_conf.intr_type = GPIO_INTR_DISABLE;
-            gpio_config(&io_conf);
+            at_wkmcu_wake_gpio_deconfig(s_wkmcu_cfg.wake_number);
         }
     }
 
@@ -612,8 +1368,21 @@ static uint8_t at_setup_cmd_userwkmcucfg(uint8_t para_num)
         s_wkmcu_cfg.delay_ms = delay_ms;
         s_wkmcu_cfg.check_mcu_awake = check_awake;
         s_wkmcu_cfg.enable = enable;
+
+        // the mcu is sending this command, but it may deassert the awake gpio right after that
+        if (check_awake & AT_MCU_AWAKE_ON_GPIO) {
+            if (gpio_get_level(awake_number) == awake_level) {
+                xEventGroupSetBits(s_wkmcu_evt_group, AT_MCU_AWAKE_ON_GPIO);
+            } else {
+                xEventGroupClearBits(s_wkmcu_evt_group, AT_MCU_AWAKE_BIT);
+                s_mcu_sleep = true;
+            }
+        }
     } else {
         memset(&s_wkmcu_cfg, 0x0, sizeof(s_wkmcu_cfg));
+        free(sp_wkmcu_buffer);
+        sp_wkmcu_buffer = NULL;
+        s_wkmcu_buffer_len = 0;
     }
 
     return ESP_AT_RESULT_CODE_OK;
@@ -675,6 +1444,11 @@ bool esp_at_user_cmd_regist(void)
 {
 #ifdef CONFIG_AT_USERWKMCU_COMMAND_SUPPORT
     s_wkmcu_evt_group = xEventGroupCreate();
+    s_wkmcu_mutex = xSemaphoreCreateMutex();
+    if (!s_wkmcu_evt_group || !s_wkmcu_mutex) {
+        return false;
+    }
+    xEventGroupSetBits(s_wkmcu_evt_group, AT_WKMCU_IDLE_BIT);
 #endif
     return esp_at_custom_cmd_array_regist(s_at_user_cmd, sizeof(s_at_user_cmd) / sizeof(s_at_user_cmd[0]));
 }
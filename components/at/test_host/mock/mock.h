@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define MOCK_TASK_MAX       16
+
+struct mock_task {
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t fn;
+    void *arg;
+    UBaseType_t priority;
+    uint32_t notify_count;
+    bool started;
+    bool deleted;
+};
+
+/**
+ * @brief The mocked system runs on a single thread. Tasks are only recorded by xTaskCreate(), and the
+ *        test calls their functions itself, except that waiting for event group bits forever runs the
+ *        tasks which have not been started yet. Other blocking calls advance the tick count by the time
+ *        they would wait.
+ */
+extern TickType_t mock_tick;
+extern struct mock_task mock_tasks[MOCK_TASK_MAX];
+extern int mock_task_num;
+extern TaskHandle_t mock_current_task;
+extern bool mock_task_create_fail;
+
+// a notification given to the current task when the tick count reaches mock_notify_tick, 0 for none
+extern TickType_t mock_notify_tick;
+
+// called by vTaskDelay() after the tick count advances, so a test can change the system while the code waits
+extern void (*mock_delay_hook)(TickType_t ticks);
+
+// called by xSemaphoreGive() after a mutex is released, so a test can run another task where it may preempt
+extern void (*mock_mutex_give_hook)(SemaphoreHandle_t mutex);
+
+// the task list returned by uxTaskGetSystemState()
+extern TaskStatus_t mock_task_status[MOCK_TASK_MAX];
+extern UBaseType_t mock_task_status_num;
+
+void mock_freertos_reset(void);
+TaskHandle_t mock_task_find(const char *name);
@@ -0,0 +1,263 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_at.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_private/cache_utils.h"
+#include "mock.h"
+#include "mock_at.h"
+
+char mock_at_output[MOCK_AT_OUTPUT_SIZE];
+int32_t mock_at_output_len;
+uint8_t mock_at_last_result;
+bool mock_flash_cache_disabled;
+
+static const char *s_paras[MOCK_AT_PARA_NUM_MAX];
+static int s_para_num;
+static const uint8_t *s_input;
+static int32_t s_input_len;
+static esp_at_port_specific_callback_t s_specific_cb;
+static const esp_at_cmd_struct *s_cmds[MOCK_AT_CMD_MAX];
+static int s_cmd_num;
+
+struct mock_esp_timer {
+    esp_timer_create_args_t args;
+    bool active;
+};
+
+void mock_at_reset(void)
+{
+    memset(mock_at_output, 0, sizeof(mock_at_output));
+    mock_at_output_len = 0;
+    mock_at_last_result = ESP_AT_RESULT_CODE_MAX;
+    mock_flash_cache_disabled = false;
+    s_para_num = 0;
+    s_input = NULL;
+    s_input_len = 0;
+    s_specific_cb = NULL;
+    s_cmd_num = 0;
+}
+
+void mock_at_set_paras(int num, const char *const *paras)
+{
+    s_para_num = num;
+    for (int i = 0; i < num && i < MOCK_AT_PARA_NUM_MAX; i++) {
+        s_paras[i] = paras[i];
+    }
+}
+
+void mock_at_set_input(const void *data, int32_t len)
+{
+    s_input = data;
+    s_input_len = len;
+}
+
+esp_at_para_parse_result_type esp_at_get_para_as_digit(int32_t para_index, int32_t *value)
+{
+    if (para_index >= s_para_num) {
+        return ESP_AT_PARA_PARSE_RESULT_FAIL;
+    }
+    if (s_paras[para_index][0] == '\0') {
+        return ESP_AT_PARA_PARSE_RESULT_OMITTED;
+    }
+    char *end = NULL;
+    long v = strtol(s_paras[para_index], &end, 10);
+    if (*end != '\0') {
+        return ESP_AT_PARA_PARSE_RESULT_FAIL;
+    }
+    *value = v;
+    return ESP_AT_PARA_PARSE_RESULT_OK;
+}
+
+esp_at_para_parse_result_type esp_at_get_para_as_str(int32_t para_index, uint8_t **result)
+{
+    if (para_index >= s_para_num) {
+        return ESP_AT_PARA_PARSE_RESULT_FAIL;
+    }
+    if (s_paras[para_index][0] == '\0') {
+        return ESP_AT_PARA_PARSE_RESULT_OMITTED;
+    }
+    *result = (uint8_t *)s_paras[para_index];
+    return ESP_AT_PARA_PARSE_RESULT_OK;
+}
+
+static int32_t mock_at_output_append(const uint8_t *data, int32_t len)
+{
+    int32_t copy = at_min(len, (int32_t)sizeof(mock_at_output) - 1 - mock_at_output_len);
+    memcpy(mock_at_output + mock_at_output_len, data, copy);
+    mock_at_output_len += copy;
+    mock_at_output[mock_at_output_len] = '\0';
+    return len;
+}
+
+int32_t esp_at_port_write_data(uint8_t *data, int32_t len)
+{
+    return mock_at_output_append(data, len);
+}
+
+int32_t esp_at_port_active_write_data(uint8_t *data, int32_t len)
+{
+    return mock_at_output_append(data, len);
+}
+
+int32_t esp_at_port_read_data(uint8_t *data, int32_t len)
+{
+    int32_t copy = at_min(len, s_input_len);
+    memcpy(data, s_input, copy);
+    s_input += copy;
+    s_input_len -= copy;
+    return copy;
+}
+
+int32_t esp_at_port_get_data_length(void)
+{
+    return s_input_len;
+}
+
+void esp_at_port_enter_specific(esp_at_port_specific_callback_t callback)
+{
+    s_specific_cb = callback;
+}
+
+void esp_at_port_exit_specific(void)
+{
+    s_specific_cb = NULL;
+}
+
+void esp_at_response_result(uint8_t result_code)
+{
+    mock_at_last_result = result_code;
+    // the host sends the data once it sees the ">" prompt
+    if (result_code == ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT && s_specific_cb && s_input_len > 0) {
+        s_specific_cb();
+    }
+}
+
+bool esp_at_custom_cmd_array_regist(const esp_at_cmd_struct *custom_at_cmd_array, uint32_t cmd_num)
+{
+    for (uint32_t i = 0; i < cmd_num; i++) {
+        const esp_at_cmd_struct *cmd = &custom_at_cmd_array[i];
+        int index = 0;
+        while (index < s_cmd_num && strcmp(s_cmds[index]->at_cmdName, cmd->at_cmdName) != 0) {
+            index++;
+        }
+        if (index == MOCK_AT_CMD_MAX) {
+            return false;
+        }
+        // a command registered again replaces the previous one
+        s_cmds[index] = cmd;
+        if (index == s_cmd_num) {
+            s_cmd_num++;
+        }
+    }
+    return true;
+}
+
+const esp_at_cmd_struct *mock_at_cmd_find(const char *name)
+{
+    for (int i = 0; i < s_cmd_num; i++) {
+        if (strcmp(s_cmds[i]->at_cmdName, name) == 0) {
+            return s_cmds[i];
+        }
+    }
+    return NULL;
+}
+
+const uint8_t *esp_at_get_current_cmd_name(void)
+{
+    return (const uint8_t *)"+TEST";
+}
+
+void esp_at_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return mock_tick;
+}
+
+void esp_log_writev(esp_log_level_t level, const char *tag, const char *format, va_list args)
+{
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    esp_timer_handle_t timer = calloc(1, sizeof(struct mock_esp_timer));
+    if (!timer) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *create_args;
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return esp_timer_start_once(timer, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    return timer->active;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    free(timer);
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)mock_tick * portTICK_PERIOD_MS * 1000;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return 100000;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    return 80000;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return 60000;
+}
+
+esp_err_t heap_caps_register_failed_alloc_callback(esp_alloc_failed_hook_t callback)
+{
+    return ESP_OK;
+}
+
+bool spi_flash_cache_enabled(void)
+{
+    return !mock_flash_cache_disabled;
+}
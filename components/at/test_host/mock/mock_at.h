@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_at_core.h"
+
+#define MOCK_AT_PARA_NUM_MAX    32
+#define MOCK_AT_OUTPUT_SIZE     8192
+#define MOCK_AT_CMD_MAX         64
+
+/**
+ * @brief The AT core of the host tests: command parameters come from mock_at_set_paras(),
+ *        the data written to the AT port is collected in mock_at_output, and the data
+ *        of the data mode is read from the input set by mock_at_set_input(). The registered
+ *        commands are kept by name, a command registered again replaces the previous one.
+ */
+extern char mock_at_output[MOCK_AT_OUTPUT_SIZE];
+extern int32_t mock_at_output_len;
+extern uint8_t mock_at_last_result;
+
+// spi_flash_cache_enabled() returns false while it is set
+extern bool mock_flash_cache_disabled;
+
+void mock_at_reset(void);
+void mock_at_set_paras(int num, const char *const *paras);
+void mock_at_set_input(const void *data, int32_t len);
+const esp_at_cmd_struct *mock_at_cmd_find(const char *name);
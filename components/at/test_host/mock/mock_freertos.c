@@ -0,0 +1,293 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "mock.h"
+
+struct mock_semaphore {
+    bool mutex;
+    uint32_t count;
+};
+
+struct mock_event_group {
+    EventBits_t bits;
+};
+
+TickType_t mock_tick;
+struct mock_task mock_tasks[MOCK_TASK_MAX];
+int mock_task_num;
+TaskHandle_t mock_current_task;
+bool mock_task_create_fail;
+TickType_t mock_notify_tick;
+void (*mock_delay_hook)(TickType_t ticks);
+void (*mock_mutex_give_hook)(SemaphoreHandle_t mutex);
+TaskStatus_t mock_task_status[MOCK_TASK_MAX];
+UBaseType_t mock_task_status_num;
+
+void mock_freertos_reset(void)
+{
+    mock_tick = 0;
+    memset(mock_tasks, 0, sizeof(mock_tasks));
+    mock_task_num = 0;
+    mock_current_task = NULL;
+    mock_task_create_fail = false;
+    mock_notify_tick = 0;
+    mock_delay_hook = NULL;
+    mock_mutex_give_hook = NULL;
+    memset(mock_task_status, 0, sizeof(mock_task_status));
+    mock_task_status_num = 0;
+}
+
+TaskHandle_t mock_task_find(const char *name)
+{
+    for (int i = 0; i < mock_task_num; i++) {
+        if (!mock_tasks[i].deleted && strcmp(mock_tasks[i].name, name) == 0) {
+            return &mock_tasks[i];
+        }
+    }
+    return NULL;
+}
+
+void mock_critical_enter(portMUX_TYPE *mux)
+{
+    mux->nesting++;
+}
+
+void mock_critical_exit(portMUX_TYPE *mux)
+{
+    if (mux->nesting <= 0) {
+        fprintf(stderr, "critical section exited without being entered\n");
+        abort();
+    }
+    mux->nesting--;
+}
+
+BaseType_t xPortInIsrContext(void)
+{
+    return pdFALSE;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id)
+{
+    if (mock_task_create_fail || mock_task_num >= MOCK_TASK_MAX) {
+        return pdFAIL;
+    }
+    struct mock_task *task = &mock_tasks[mock_task_num++];
+    memset(task, 0, sizeof(*task));
+    snprintf(task->name, sizeof(task->name), "%s", name);
+    task->fn = fn;
+    task->arg = arg;
+    task->priority = priority;
+    if (created_task) {
+        *created_task = task;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, created_task, -1);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    task = task ? task : mock_current_task;
+    if (task) {
+        task->deleted = true;
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    mock_tick += ticks;
+    if (mock_delay_hook) {
+        mock_delay_hook(ticks);
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return mock_tick;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return mock_current_task;
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    task = task ? task : mock_current_task;
+    return task ? task->name : "main";
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    task = task ? task : mock_current_task;
+    return task ? task->priority : 0;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    return mock_task_status_num;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status_array, UBaseType_t array_size,
+                                 configRUN_TIME_COUNTER_TYPE *total_run_time)
+{
+    if (array_size < mock_task_status_num) {
+        return 0;
+    }
+    memcpy(status_array, mock_task_status, mock_task_status_num * sizeof(TaskStatus_t));
+    if (total_run_time) {
+        *total_run_time = mock_tick * 1000;
+    }
+    return mock_task_status_num;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    struct mock_task *task = mock_current_task;
+    if (task && task->notify_count) {
+        uint32_t count = task->notify_count;
+        task->notify_count = clear_on_exit ? 0 : count - 1;
+        return count;
+    }
+    // a scripted notification arrives while waiting
+    if (mock_notify_tick && (ticks_to_wait == portMAX_DELAY || mock_notify_tick <= mock_tick
+                             || mock_notify_tick - mock_tick <= ticks_to_wait)) {
+        if (mock_notify_tick > mock_tick) {
+            mock_tick = mock_notify_tick;
+        }
+        mock_notify_tick = 0;
+        return 1;
+    }
+    if (ticks_to_wait != portMAX_DELAY) {
+        mock_tick += ticks_to_wait;
+    }
+    return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notify_count++;
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t sema = calloc(1, sizeof(struct mock_semaphore));
+    if (sema) {
+        sema->mutex = true;
+        sema->count = 1;
+    }
+    return sema;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return calloc(1, sizeof(struct mock_semaphore));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sema, TickType_t ticks_to_wait)
+{
+    if (sema->count) {
+        sema->count--;
+        return pdTRUE;
+    }
+    if (sema->mutex) {
+        // nothing else runs, so a mutex which is still taken is a deadlock of the code under test
+        fprintf(stderr, "mutex taken twice\n");
+        abort();
+    }
+    if (ticks_to_wait != portMAX_DELAY) {
+        mock_tick += ticks_to_wait;
+    }
+    return pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sema)
+{
+    // both mutexes and binary semaphores hold one token at most
+    if (sema->count) {
+        return pdFALSE;
+    }
+    sema->count = 1;
+    if (sema->mutex && mock_mutex_give_hook) {
+        mock_mutex_give_hook(sema);
+    }
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sema)
+{
+    free(sema);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return calloc(1, sizeof(struct mock_event_group));
+}
+
+void vEventGroupDelete(EventGroupHandle_t group)
+{
+    free(group);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    group->bits |= bits;
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    EventBits_t old = group->bits;
+    group->bits &= ~bits;
+    return old;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    EventBits_t cur = group->bits;
+    bool done = wait_for_all ? ((cur & bits) == bits) : ((cur & bits) != 0);
+
+    // nothing else could set the bits, so the tasks created so far run until they do
+    for (int i = 0; !done && ticks_to_wait == portMAX_DELAY && i < mock_task_num; i++) {
+        struct mock_task *task = &mock_tasks[i];
+        if (task->started || task->deleted) {
+            continue;
+        }
+        TaskHandle_t caller = mock_current_task;
+        task->started = true;
+        mock_current_task = task;
+        task->fn(task->arg);
+        mock_current_task = caller;
+
+        cur = group->bits;
+        done = wait_for_all ? ((cur & bits) == bits) : ((cur & bits) != 0);
+    }
+    if (done && clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    if (!done && ticks_to_wait != portMAX_DELAY) {
+        mock_tick += ticks_to_wait;
+    }
+    return cur;
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "nvs_flash.h"
+#include "esp_at_core.h"
+#include "mock_nvs.h"
+
+// the platform calls which the tests do not look at
+
+static const esp_partition_t s_mfg_nvs_partition = {
+    .type = ESP_PARTITION_TYPE_DATA,
+    .subtype = ESP_PARTITION_SUBTYPE_DATA_NVS,
+    .label = "mfg_nvs",
+};
+
+static const esp_partition_t s_factory_param_partition = {
+    .type = 0x40,
+    .subtype = 0xff,
+    .size = 0x1000,
+    .label = "factory_param",
+};
+
+static const uint8_t *s_factory_param_data;
+static size_t s_factory_param_len;
+
+void mock_nvs_set_factory_param_partition(const void *data, size_t len)
+{
+    s_factory_param_data = data;
+    s_factory_param_len = len;
+}
+
+const esp_partition_t *esp_at_custom_partition_find(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    const esp_partition_t *partition = s_factory_param_data ? &s_factory_param_partition : &s_mfg_nvs_partition;
+    return strcmp(label, partition->label) == 0 ? partition : NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if (partition != &s_factory_param_partition || src_offset + size > partition->size) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    memset(dst, 0xff, size);
+    if (src_offset < s_factory_param_len) {
+        size_t len = s_factory_param_len - src_offset;
+        memcpy(dst, s_factory_param_data + src_offset, len < size ? len : size);
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_init_partition_ptr(const esp_partition_t *partition)
+{
+    return ESP_OK;
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+}
+
+int esp_rom_printf(const char *fmt, ...)
+{
+    return 0;
+}
+
+esp_err_t esp_netif_init(void)
+{
+    return ESP_OK;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_sta(void)
+{
+    return NULL;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_ap(void)
+{
+    return NULL;
+}
+
+esp_err_t esp_wifi_stop(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_deinit(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_max_tx_power(int8_t power)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_country(const wifi_country_t *country)
+{
+    return ESP_OK;
+}
@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+#include "mock_nvs.h"
+
+#define MOCK_NVS_HANDLE_MAX     8
+
+static const mock_nvs_entry_t *s_entries;
+static int s_entry_num;
+static const char *s_handles[MOCK_NVS_HANDLE_MAX];
+
+void mock_nvs_set_entries(const mock_nvs_entry_t *entries, int num)
+{
+    s_entries = entries;
+    s_entry_num = num;
+}
+
+static const char *mock_nvs_find(nvs_handle_t handle, const char *key)
+{
+    if (handle == 0 || handle > MOCK_NVS_HANDLE_MAX || !s_handles[handle - 1]) {
+        return NULL;
+    }
+    for (int i = 0; i < s_entry_num; i++) {
+        if (strcmp(s_entries[i].namespace_name, s_handles[handle - 1]) == 0 && strcmp(s_entries[i].key, key) == 0) {
+            return s_entries[i].value;
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t mock_nvs_get_number(nvs_handle_t handle, const char *key, long long *out_value)
+{
+    const char *value = mock_nvs_find(handle, key);
+    if (!value) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *out_value = strtoll(value, NULL, 0);
+    return ESP_OK;
+}
+
+esp_err_t nvs_open_from_partition(const char *part_name, const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    for (int i = 0; i < s_entry_num; i++) {
+        if (strcmp(s_entries[i].namespace_name, namespace_name) != 0) {
+            continue;
+        }
+        for (int h = 0; h < MOCK_NVS_HANDLE_MAX; h++) {
+            if (!s_handles[h]) {
+                s_handles[h] = namespace_name;
+                *out_handle = h + 1;
+                return ESP_OK;
+            }
+        }
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    if (handle > 0 && handle <= MOCK_NVS_HANDLE_MAX) {
+        s_handles[handle - 1] = NULL;
+    }
+}
+
+#define MOCK_NVS_GET_NUMBER(fn, type) \
+    esp_err_t fn(nvs_handle_t handle, const char *key, type *out_value) \
+    { \
+        long long value = 0; \
+        esp_err_t ret = mock_nvs_get_number(handle, key, &value); \
+        if (ret == ESP_OK) { \
+            *out_value = (type)value; \
+        } \
+        return ret; \
+    }
+
+MOCK_NVS_GET_NUMBER(nvs_get_i8, int8_t)
+MOCK_NVS_GET_NUMBER(nvs_get_u8, uint8_t)
+MOCK_NVS_GET_NUMBER(nvs_get_i32, int32_t)
+MOCK_NVS_GET_NUMBER(nvs_get_u32, uint32_t)
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    const char *value = mock_nvs_find(handle, key);
+    if (!value) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out_value) {
+        if (*length < strlen(value) + 1) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        strcpy(out_value, value);
+    }
+    *length = strlen(value) + 1;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return nvs_get_str(handle, key, out_value, length);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief The nvs of the host tests is a list of "namespace", "key", "value" strings.
+ *        Numbers are parsed from their value, a namespace without keys cannot be opened.
+ */
+typedef struct {
+    const char *namespace_name;
+    const char *key;
+    const char *value;
+} mock_nvs_entry_t;
+
+void mock_nvs_set_entries(const mock_nvs_entry_t *entries, int num);
+
+/**
+ * @brief Replace the "mfg_nvs" partition with a legacy "factory_param" partition holding <data>,
+ *        the rest of the partition reads as erased flash. NULL restores the "mfg_nvs" partition.
+ */
+void mock_nvs_set_factory_param_partition(const void *data, size_t len);
@@ -0,0 +1,13 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define DRAM_STR(str)               (str)
+#define _COUNTER_STRINGIFY(c)       #c
+#define _SECTION_ATTR_IMPL(s, c)    __attribute__((section(s "." _COUNTER_STRINGIFY(c))))
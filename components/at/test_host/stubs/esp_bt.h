@@ -0,0 +1,17 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "esp_err.h"
+
+typedef enum {
+    ESP_BT_MODE_IDLE = 0,
+    ESP_BT_MODE_BLE = 1,
+    ESP_BT_MODE_CLASSIC_BT = 2,
+    ESP_BT_MODE_BTDM = 3,
+} esp_bt_mode_t;
+
+esp_err_t esp_bt_controller_mem_release(esp_bt_mode_t mode);
@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+    ESP_LOG_MAX,
+} esp_log_level_t;
+
+// the host tests keep the output quiet, the logs are only type checked
+#define ESP_HOST_LOG(format, ...)   do { if (0) { printf(format, ##__VA_ARGS__); } } while (0)
+#define ESP_LOGE(tag, format, ...)  ESP_HOST_LOG(format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  ESP_HOST_LOG(format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  ESP_HOST_LOG(format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  ESP_HOST_LOG(format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)  ESP_HOST_LOG(format, ##__VA_ARGS__)
+#define ESP_LOG_BUFFER_HEXDUMP(tag, buffer, buff_len, level)
+
+#define LOG_ANSI_COLOR_RED              "31"
+#define LOG_ANSI_COLOR_REGULAR(color)   "\033[0;" color "m"
+#define LOG_ANSI_COLOR_RESET            "\033[0m"
+
+void esp_log_level_set(const char *tag, esp_log_level_t level);
+int esp_rom_printf(const char *fmt, ...);
+
+uint32_t esp_log_timestamp(void);
+void esp_log_writev(esp_log_level_t level, const char *tag, const char *format, va_list args);
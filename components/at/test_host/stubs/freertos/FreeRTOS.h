@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+// FreeRTOS API of the host tests, implemented by mock/mock_freertos.c on a single thread
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "esp_bit_defs.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE                     ((BaseType_t)0)
+#define pdTRUE                      ((BaseType_t)1)
+#define pdFAIL                      pdFALSE
+#define pdPASS                      pdTRUE
+#define portMAX_DELAY               ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS          ((TickType_t)(1000 / CONFIG_FREERTOS_HZ))
+#define portNUM_PROCESSORS          CONFIG_FREERTOS_NUMBER_OF_CORES
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(((uint64_t)(ms) * CONFIG_FREERTOS_HZ) / 1000))
+#define configMAX_TASK_NAME_LEN     16
+#define configRUN_TIME_COUNTER_TYPE uint32_t
+
+typedef struct {
+    int nesting;            /*!< the depth of the critical sections entered with this lock */
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { .nesting = 0 }
+
+void mock_critical_enter(portMUX_TYPE *mux);
+void mock_critical_exit(portMUX_TYPE *mux);
+
+#define portENTER_CRITICAL(mux)         mock_critical_enter(mux)
+#define portEXIT_CRITICAL(mux)          mock_critical_exit(mux)
+#define portENTER_CRITICAL_ISR(mux)     mock_critical_enter(mux)
+#define portEXIT_CRITICAL_ISR(mux)      mock_critical_exit(mux)
+#define portENTER_CRITICAL_SAFE(mux)    mock_critical_enter(mux)
+#define portEXIT_CRITICAL_SAFE(mux)     mock_critical_exit(mux)
+
+BaseType_t xPortInIsrContext(void);
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+// configuration of the host tests, the features under test are enabled
+#define CONFIG_IDF_TARGET_ESP32C3                   1
+#define CONFIG_IDF_TARGET                           "esp32c3"
+#define CONFIG_FREERTOS_HZ                          1000
+#define CONFIG_FREERTOS_NUMBER_OF_CORES             1
+#define CONFIG_AT_LOG_DEFAULT_LEVEL                 0
+
+#define CONFIG_AT_PROCESS_TASK_STACK_SIZE           5120
+#define CONFIG_AT_NET_COMMAND_SUPPORT               1
+#define CONFIG_AT_SOCKET_TASK_STACK_SIZE            4096
+#define CONFIG_AT_SOCKET_MAX_CONN_NUM               5
+#define CONFIG_AT_HTTP_COMMAND_SUPPORT              1
+#define CONFIG_AT_HTTP_TX_BUFFER_SIZE               2048
+#define CONFIG_AT_HTTP_RX_BUFFER_SIZE               2048
+#define CONFIG_AT_OTA_SUPPORT                       1
+#define CONFIG_AT_OTA_TOKEN_KEY                     "0123456789abcdef0123456789abcdef01234567"
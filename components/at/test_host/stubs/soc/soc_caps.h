@@ -0,0 +1,9 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+// the capabilities of ESP32-C3, the target of the host tests
+#define SOC_RMT_SUPPORT_DMA         0
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+
+#define CONFIG_AT_WIFI_COMMAND_SUPPORT      1
+#define CONFIG_BT_ENABLED                   1
+#define CONFIG_AT_BLE_COMMAND_SUPPORT       1
+#define CONFIG_AT_PARALLEL_BOOT_SUPPORT     1
+#define CONFIG_AT_BOOT_PROFILE_SUPPORT      1
+#include "at_init.c"
+#include "at_boot_prof.c"
+#include "mock.h"
+#include "mock_at.h"
+#include "mock_nvs.h"
+
+#define TEST_EVENT_MAX      32
+
+// the order in which the boot flow reached the mocked steps
+static const char *s_events[TEST_EVENT_MAX];
+static int s_event_num;
+
+static void test_event(const char *name)
+{
+    if (s_event_num < TEST_EVENT_MAX) {
+        s_events[s_event_num++] = name;
+    }
+    // every step takes 1 ms
+    mock_tick++;
+}
+
+static int test_event_index(const char *name)
+{
+    for (int i = 0; i < s_event_num; i++) {
+        if (strcmp(s_events[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static const at_boot_phase_t *test_boot_phase_find(const char *name)
+{
+    for (int i = 0; i < s_boot_phase_num; i++) {
+        if (strcmp(s_boot_phases[i].name, name) == 0) {
+            return &s_boot_phases[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    test_event("wifi_init");
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    test_event("wifi_start");
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage)
+{
+    test_event("wifi_set_storage");
+    return ESP_OK;
+}
+
+esp_err_t esp_bt_controller_mem_release(esp_bt_mode_t mode)
+{
+    test_event("bt_mem_release");
+    return ESP_OK;
+}
+
+void at_interface_init(void)
+{
+    test_event("interface_init");
+}
+
+void at_interface_start(void)
+{
+    test_event("interface_start");
+}
+
+void esp_at_module_init(const uint8_t *custom_version)
+{
+    test_event("module_init");
+}
+
+void esp_at_cmd_set_register(void)
+{
+    test_event("cmd_set_register");
+}
+
+void esp_at_set_module_id(uint32_t id)
+{
+}
+
+void esp_at_set_module_id_by_str(const char *buffer)
+{
+}
+
+const char *esp_at_get_current_module_name(void)
+{
+    return "MINI-1";
+}
+
+esp_err_t esp_at_nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return nvs_get_str(handle, key, out_value, length);
+}
+
+static void test_boot_reset(void)
+{
+    static const mock_nvs_entry_t mfg_nvs[] = {
+        {"factory_param", "module_name", "MINI-1"},
+    };
+
+    mock_freertos_reset();
+    // an end time of 0 means that the phase did not end, so the boot starts later
+    mock_tick = 1;
+    mock_at_reset();
+    mock_nvs_set_entries(mfg_nvs, sizeof(mfg_nvs) / sizeof(mfg_nvs[0]));
+    s_event_num = 0;
+    s_boot_phase_num = 0;
+    s_boot_phase_cur = -1;
+    mock_task_create_fail = false;
+}
+
+static void test_boot_parallel(void)
+{
+    test_boot_reset();
+    esp_at_init();
+
+    // the stages ran on their own tasks, and were joined before their results were used
+    TEST_ASSERT(mock_task_find("wifi_init") == NULL);
+    TEST_ASSERT_EQUAL(2, mock_task_num);
+    TEST_ASSERT(test_event_index("wifi_start") < test_event_index("wifi_set_storage"));
+    TEST_ASSERT(test_event_index("bt_mem_release") < test_event_index("cmd_set_register"));
+    TEST_ASSERT(test_event_index("interface_init") < test_event_index("wifi_init"));
+    TEST_ASSERT_EQUAL_STRING("\r\nready\r\n", mock_at_output);
+
+    // the stages are in the boot profile with their own timing, next to the phases of esp_at_init()
+    const at_boot_phase_t *wifi = test_boot_phase_find("wifi_init");
+    const at_boot_phase_t *bt = test_boot_phase_find("bt_mem_release");
+    TEST_ASSERT(wifi && bt);
+    if (wifi && bt) {
+        TEST_ASSERT_EQUAL(2000, wifi->end_us - wifi->start_us);
+        TEST_ASSERT_EQUAL(1000, bt->end_us - bt->start_us);
+    }
+    TEST_ASSERT(test_boot_phase_find("stage_join") != NULL);
+
+    // every phase of esp_at_init() ended, the parallel stages did not cut them short
+    for (int i = 0; i < s_boot_phase_num; i++) {
+        TEST_ASSERT(s_boot_phases[i].end_us >= s_boot_phases[i].start_us);
+        TEST_ASSERT(s_boot_phases[i].end_us != 0);
+    }
+    const at_boot_phase_t *intf = test_boot_phase_find("interface_init");
+    TEST_ASSERT(intf && intf->end_us - intf->start_us == 1000);
+}
+
+static void test_boot_fallback_in_sequence(void)
+{
+    test_boot_reset();
+    mock_task_create_fail = true;
+    esp_at_init();
+
+    // no task could be created, the stages ran in place in the same order
+    TEST_ASSERT_EQUAL(0, mock_task_num);
+    TEST_ASSERT(test_event_index("wifi_start") < test_event_index("bt_mem_release"));
+    TEST_ASSERT(test_event_index("bt_mem_release") < test_event_index("interface_init"));
+    TEST_ASSERT(test_boot_phase_find("stage_join") == NULL);
+
+    const at_boot_phase_t *wifi = test_boot_phase_find("wifi_init");
+    TEST_ASSERT(wifi && wifi->end_us - wifi->start_us == 2000);
+}
+
+int main(void)
+{
+    RUN_TEST(test_boot_parallel);
+    RUN_TEST(test_boot_fallback_in_sequence);
+    return TEST_RESULT();
+}
@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+
+#include "at_buzz_cmd.c"
+#include "mock.h"
+#include "mock_at.h"
+
+// the LEDC driver, every duty update is kept with the tick it happened at
+#define TEST_TONE_MAX   16
+
+struct test_tone {
+    TickType_t tick;
+    uint32_t freq_hz;
+    uint32_t duty;
+};
+
+static uint32_t s_ledc_freq;
+static uint32_t s_ledc_duty;
+static struct test_tone s_tones[TEST_TONE_MAX];
+static int s_tone_num;
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    s_ledc_freq = timer_conf->freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    s_ledc_duty = ledc_conf->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_freq(ledc_mode_t speed_mode, ledc_timer_t timer_num, uint32_t freq_hz)
+{
+    s_ledc_freq = freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    s_ledc_duty = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (s_tone_num < TEST_TONE_MAX) {
+        s_tones[s_tone_num++] = (struct test_tone) {mock_tick, s_ledc_duty ? s_ledc_freq : 0, s_ledc_duty};
+    }
+    return ESP_OK;
+}
+
+static void test_assert_tone(int index, TickType_t tick, uint32_t freq_hz, uint32_t duty)
+{
+    TEST_ASSERT(index < s_tone_num);
+    TEST_ASSERT_EQUAL(tick, s_tones[index].tick);
+    TEST_ASSERT_EQUAL(freq_hz, s_tones[index].freq_hz);
+    TEST_ASSERT_EQUAL(duty, s_tones[index].duty);
+}
+
+static int test_parse(const char *text, at_buzz_seq_t *seq)
+{
+    return at_buzz_seq_parse((const uint8_t *)text, strlen(text), seq);
+}
+
+static void test_buzz_reset(void)
+{
+    mock_freertos_reset();
+    mock_tick = 1;
+    mock_at_reset();
+    s_tone_num = 0;
+
+    at_buzz_init();
+    // the sequencer runs on the test thread
+    mock_current_task = buzz_seq_task;
+    s_tone_num = 0;
+}
+
+static void test_buzz_seq_parse(void)
+{
+    at_buzz_seq_t seq;
+
+    TEST_ASSERT_EQUAL(0, test_parse("440,100,50,0,50,0,20000,60000,100\r\n", &seq));
+    TEST_ASSERT_EQUAL(3, seq.note_num);
+    TEST_ASSERT_EQUAL(440, seq.notes[0].freq_hz);
+    TEST_ASSERT_EQUAL(100, seq.notes[0].duration_ms);
+    TEST_ASSERT_EQUAL(50, seq.notes[0].volume);
+    TEST_ASSERT_EQUAL(0, seq.notes[1].freq_hz);
+    TEST_ASSERT_EQUAL(20000, seq.notes[2].freq_hz);
+    TEST_ASSERT_EQUAL(60000, seq.notes[2].duration_ms);
+    TEST_ASSERT_EQUAL(100, seq.notes[2].volume);
+
+    // the longest sequence, and one more note
+    char text[BUZZ_SEQ_PAYLOAD_MAX + BUZZ_SEQ_NOTE_TEXT_MAX] = "";
+    for (int i = 0; i < BUZZ_SEQ_NOTE_NUM; i++) {
+        strcat(text, i ? ",20,1,1" : "20,1,1");
+    }
+    TEST_ASSERT_EQUAL(0, test_parse(text, &seq));
+    TEST_ASSERT_EQUAL(BUZZ_SEQ_NOTE_NUM, seq.note_num);
+    strcat(text, ",20,1,1");
+    TEST_ASSERT_EQUAL(-1, test_parse(text, &seq));
+
+    const char *const invalid[] = {
+        "", "\r\n", "440", "440,100", "440,100,50,", "440,100,50,0", ",440,100,50", "440,,50",
+        "440;100;50", "440,100,50 ", "-440,100,50", "123456,1,1",
+        "19,100,50", "20001,100,50", "440,0,50", "440,60001,50", "440,100,101",
+    };
+    for (int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT_EQUAL(-1, test_parse(invalid[i], &seq));
+    }
+}
+
+static void test_buzz_seq_play_timing(void)
+{
+    test_buzz_reset();
+
+    at_buzz_seq_t seq;
+    TEST_ASSERT_EQUAL(0, test_parse("440,100,50,0,50,0,880,30,100", &seq));
+    seq.loops = 2;
+    TEST_ASSERT(!at_buzz_seq_play(&seq));
+
+    // the notes start on absolute deadlines, and the buzzer is silent at the end
+    TEST_ASSERT_EQUAL(7, s_tone_num);
+    test_assert_tone(0, 1, 440, LEDC_DUTY / 2);
+    test_assert_tone(1, 101, 0, 0);
+    test_assert_tone(2, 151, 880, LEDC_DUTY);
+    test_assert_tone(3, 181, 440, LEDC_DUTY / 2);
+    test_assert_tone(4, 281, 0, 0);
+    test_assert_tone(5, 331, 880, LEDC_DUTY);
+    test_assert_tone(6, 361, 0, 0);
+    TEST_ASSERT_EQUAL(361, mock_tick);
+
+    // a volume of 0 is a rest whatever the frequency
+    s_tone_num = 0;
+    TEST_ASSERT_EQUAL(0, test_parse("440,10,0", &seq));
+    seq.loops = 1;
+    TEST_ASSERT(!at_buzz_seq_play(&seq));
+    test_assert_tone(0, 361, 0, 0);
+}
+
+static void test_buzz_seq_play_interrupt(void)
+{
+    test_buzz_reset();
+
+    // a new request stops the sequence in the middle of a note, and the
+    // buzzer is left to the next sequence
+    at_buzz_seq_t seq;
+    TEST_ASSERT_EQUAL(0, test_parse("440,100,50,880,100,50", &seq));
+    seq.loops = 0;
+    mock_notify_tick = 1001;
+    TEST_ASSERT(at_buzz_seq_play(&seq));
+    TEST_ASSERT_EQUAL(1001, mock_tick);
+    TEST_ASSERT_EQUAL(10, s_tone_num);
+    test_assert_tone(9, 901, 880, LEDC_DUTY / 2);
+
+    // AT+BUZZ holds its tone until the next request
+    s_tone_num = 0;
+    const char *const tone[] = {"1000"};
+    mock_at_set_paras(1, tone);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_setup_cmd_buzz(1));
+    TEST_ASSERT_EQUAL(1, buzz_seq_task->notify_count);
+    buzz_seq_task->notify_count = 0;
+    TEST_ASSERT_EQUAL(1, buzz_seq_request.note_num);
+    TEST_ASSERT_EQUAL(0, buzz_seq_request.notes[0].duration_ms);
+    mock_notify_tick = 5001;
+    TEST_ASSERT(at_buzz_seq_play(&buzz_seq_request));
+    TEST_ASSERT_EQUAL(1, s_tone_num);
+    test_assert_tone(0, 1001, 1000, LEDC_DUTY);
+
+    // AT+BUZZ=0 stops the sequence and plays nothing
+    const char *const stop[] = {"0"};
+    mock_at_set_paras(1, stop);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_setup_cmd_buzz(1));
+    TEST_ASSERT_EQUAL(0, buzz_seq_request.note_num);
+    const char *const out_of_range[] = {"20001"};
+    mock_at_set_paras(1, out_of_range);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, at_setup_cmd_buzz(1));
+}
+
+static void test_buzzseq_cmd(void)
+{
+    test_buzz_reset();
+
+    const char *const paras[] = {"3", "20"};
+    mock_at_set_paras(2, paras);
+    mock_at_set_input("262,200,80,0,100,0\r\n", 20);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_setup_cmd_buzzseq(2));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT, mock_at_last_result);
+    TEST_ASSERT_EQUAL(1, buzz_seq_task->notify_count);
+    TEST_ASSERT_EQUAL(3, buzz_seq_request.loops);
+    TEST_ASSERT_EQUAL(2, buzz_seq_request.note_num);
+    TEST_ASSERT_EQUAL(262, buzz_seq_request.notes[0].freq_hz);
+    TEST_ASSERT_EQUAL(100, buzz_seq_request.notes[1].duration_ms);
+
+    // an invalid payload is rejected after it is received, and the sequence playing goes on
+    buzz_seq_task->notify_count = 0;
+    mock_at_set_paras(2, (const char *const[]) {"1", "9"});
+    mock_at_set_input("440,0,50\n", 9);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, at_setup_cmd_buzzseq(2));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT, mock_at_last_result);
+    TEST_ASSERT_EQUAL(0, buzz_seq_task->notify_count);
+    TEST_ASSERT_EQUAL(3, buzz_seq_request.loops);
+
+    // the parameters are checked before the prompt
+    char max_plus_one[8];
+    snprintf(max_plus_one, sizeof(max_plus_one), "%d", BUZZ_SEQ_PAYLOAD_MAX + 1);
+    const char *const *invalid[] = {
+        (const char *const[]) {"-1", "9"},
+        (const char *const[]) {"1", "0"},
+        (const char *const[]) {"1", max_plus_one},
+    };
+    for (int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        mock_at_reset();
+        mock_at_set_paras(2, invalid[i]);
+        TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, at_setup_cmd_buzzseq(2));
+        TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_MAX, mock_at_last_result);
+    }
+    const char *const extra[] = {"1", "9", "1"};
+    mock_at_set_paras(3, extra);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, at_setup_cmd_buzzseq(3));
+    TEST_ASSERT_EQUAL(0, buzz_seq_task->notify_count);
+}
+
+int main(void)
+{
+    RUN_TEST(test_buzz_seq_parse);
+    RUN_TEST(test_buzz_seq_play_timing);
+    RUN_TEST(test_buzz_seq_play_interrupt);
+    RUN_TEST(test_buzzseq_cmd);
+    return TEST_RESULT();
+}
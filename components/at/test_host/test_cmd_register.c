@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+#include "esp_attr.h"
+
+#define CONFIG_AT_BASE_COMMAND_SUPPORT      1
+#define CONFIG_AT_MQTT_COMMAND_SUPPORT      1
+#define CONFIG_AT_BLE_COMMAND_SUPPORT       1
+#define CONFIG_AT_BLE_HID_COMMAND_SUPPORT   1
+#define CONFIG_AT_LAZY_CMD_SET_REGISTER     1
+#include "at_cmd_register.c"
+#include "mock_at.h"
+
+#define TEST_LOG_MAX    16
+
+// the command sets in the order their commands were registered
+static const char *s_log[TEST_LOG_MAX];
+static int s_log_num;
+
+static uint8_t test_builtin_setup(uint8_t para_num)
+{
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t test_custom_setup(uint8_t para_num)
+{
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static bool test_cmd_set_regist(const char *set, const esp_at_cmd_struct *cmds, uint32_t num)
+{
+    bool ret = esp_at_custom_cmd_array_regist(cmds, num);
+    if (s_log_num < TEST_LOG_MAX) {
+        s_log[s_log_num++] = set;
+    }
+    return ret;
+}
+
+#define TEST_CMD_SET(fn, ...) \
+    bool fn(void) \
+    { \
+        static const esp_at_cmd_struct cmds[] = {__VA_ARGS__}; \
+        return test_cmd_set_regist(#fn, cmds, sizeof(cmds) / sizeof(cmds[0])); \
+    }
+
+#define TEST_BUILTIN_CMD(name)  {name, NULL, NULL, test_builtin_setup, NULL}
+#define TEST_CUSTOM_CMD(name)   {name, NULL, NULL, test_custom_setup, NULL}
+
+// the built-in command sets
+TEST_CMD_SET(esp_at_base_cmd_regist, TEST_BUILTIN_CMD("+GMR"))
+TEST_CMD_SET(esp_at_net_cmd_regist, TEST_BUILTIN_CMD("+CIPSEND"))
+TEST_CMD_SET(esp_at_mqtt_cmd_regist, TEST_BUILTIN_CMD("+MQTTCONN"), TEST_BUILTIN_CMD("+MQTTPUB"))
+TEST_CMD_SET(esp_at_http_cmd_regist, TEST_BUILTIN_CMD("+HTTPCLIENT"), TEST_BUILTIN_CMD("+HTTPGETSIZE"))
+TEST_CMD_SET(esp_at_ble_cmd_regist, TEST_BUILTIN_CMD("+BLEINIT"))
+TEST_CMD_SET(esp_at_ble_hid_cmd_regist, TEST_BUILTIN_CMD("+BLEHIDINIT"))
+
+// the command sets of an application, which override built-in commands
+TEST_CMD_SET(test_user_cmd_regist, TEST_CUSTOM_CMD("+USERCMD"), TEST_CUSTOM_CMD("+HTTPCLIENT"))
+ESP_AT_CMD_SET_INIT_FN(test_user_cmd_regist, 1);
+TEST_CMD_SET(test_user_last_cmd_regist, TEST_CUSTOM_CMD("+MQTTPUB"))
+ESP_AT_CMD_SET_LAST_INIT_FN(test_user_last_cmd_regist, 1);
+
+static int test_log_index(const char *set)
+{
+    for (int i = 0; i < s_log_num; i++) {
+        if (strcmp(s_log[i], set) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void test_check(const char *data)
+{
+    esp_at_cmd_set_lazy_register_check((const uint8_t *)data, strlen(data));
+}
+
+static bool test_cmd_registered(const char *name)
+{
+    return mock_at_cmd_find(name) != NULL;
+}
+
+static void test_cmd_register_reset(void)
+{
+    mock_at_reset();
+    s_log_num = 0;
+    for (at_lazy_cmd_set_t *set = s_lazy_cmd_sets; set->prefix; ++set) {
+        set->registered = false;
+    }
+    s_lazy_state = AT_LAZY_STATE_IDLE;
+    s_lazy_data_mode = false;
+    s_lazy_transmit_mode = false;
+    esp_at_cmd_set_register();
+}
+
+static void test_cmd_register_order(void)
+{
+    test_cmd_register_reset();
+
+    // the first sets are sorted by their priority, the deferred ones are left out
+    TEST_ASSERT_EQUAL(0, test_log_index("esp_at_base_cmd_regist"));
+    TEST_ASSERT_EQUAL(1, test_log_index("esp_at_net_cmd_regist"));
+    TEST_ASSERT(!test_cmd_registered("+BLEINIT"));
+    TEST_ASSERT(!test_cmd_registered("+BLEHIDINIT"));
+
+    // a deferred set overridden by a later set is registered right before the override,
+    // so the command of the application still wins
+    TEST_ASSERT_EQUAL(2, test_log_index("esp_at_http_cmd_regist"));
+    TEST_ASSERT_EQUAL(3, test_log_index("test_user_cmd_regist"));
+    TEST_ASSERT_EQUAL(4, test_log_index("esp_at_mqtt_cmd_regist"));
+    TEST_ASSERT_EQUAL(5, test_log_index("test_user_last_cmd_regist"));
+    TEST_ASSERT_EQUAL(6, s_log_num);
+    TEST_ASSERT(mock_at_cmd_find("+HTTPCLIENT")->at_setupCmd == test_custom_setup);
+    TEST_ASSERT(mock_at_cmd_find("+HTTPGETSIZE")->at_setupCmd == test_builtin_setup);
+    TEST_ASSERT(mock_at_cmd_find("+MQTTPUB")->at_setupCmd == test_custom_setup);
+    TEST_ASSERT(mock_at_cmd_find("+MQTTCONN")->at_setupCmd == test_builtin_setup);
+    TEST_ASSERT_EQUAL(2, s_lazy_pending_num);
+
+    // using the commands later does not register the sets again
+    test_check("AT+HTTPCLIENT=2,0,\"http://host\",,,1\r\nAT+MQTTPUB=0,\"t\",\"d\",0,0\r\n");
+    TEST_ASSERT_EQUAL(6, s_log_num);
+    TEST_ASSERT(mock_at_cmd_find("+HTTPCLIENT")->at_setupCmd == test_custom_setup);
+}
+
+static void test_cmd_register_chunks(void)
+{
+    test_cmd_register_reset();
+
+    // the command name is matched across the read chunks, once it ends
+    const char *const chunks[] = {"A", "T", "+B", "LEINI", "T"};
+    for (int i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        test_check(chunks[i]);
+        TEST_ASSERT(!test_cmd_registered("+BLEINIT"));
+    }
+    test_check("=1\r\n");
+    TEST_ASSERT(test_cmd_registered("+BLEINIT"));
+
+    // "BLEINIT" only matches the "BLE" prefix, not the "BLEHID" one
+    TEST_ASSERT(!test_cmd_registered("+BLEHIDINIT"));
+    test_check("AT+BLEHIDINIT?\r\n");
+    TEST_ASSERT(test_cmd_registered("+BLEHIDINIT"));
+    TEST_ASSERT_EQUAL(0, s_lazy_pending_num);
+
+    // a BLE HID command needs both of the sets, in their boot order
+    test_cmd_register_reset();
+    test_check("AAT+BLEHIDINIT=1\r\n");
+    int ble = test_log_index("esp_at_ble_cmd_regist");
+    int ble_hid = test_log_index("esp_at_ble_hid_cmd_regist");
+    TEST_ASSERT(ble >= 0 && ble_hid == ble + 1);
+
+    // names which are too short, other names and lower case do not match
+    test_cmd_register_reset();
+    test_check("AT+BL\r\nAT+BTINIT?\r\nat+bleinit?\r\nAT+\r\nA T+BLEINIT\r\n");
+    TEST_ASSERT_EQUAL(2, s_lazy_pending_num);
+}
+
+static void test_cmd_register_cmd_list(void)
+{
+    test_cmd_register_reset();
+
+    // AT+CMD? lists all the commands, and needs all the sets
+    test_check("AT+CMD?\r\n");
+    TEST_ASSERT(test_cmd_registered("+BLEINIT"));
+    TEST_ASSERT(test_cmd_registered("+BLEHIDINIT"));
+    TEST_ASSERT_EQUAL(0, s_lazy_pending_num);
+    TEST_ASSERT(mock_at_cmd_find("+HTTPCLIENT")->at_setupCmd == test_custom_setup);
+
+    // "CMD" is the whole name, not a prefix
+    test_cmd_register_reset();
+    test_check("AT+CMDX?\r\n");
+    TEST_ASSERT_EQUAL(2, s_lazy_pending_num);
+}
+
+static void test_wait_data_cb(void)
+{
+}
+
+static void test_cmd_register_data_mode(void)
+{
+    test_cmd_register_reset();
+
+    // the payload after the ">" prompt may look like a command
+    test_check("AT+CIPSEND=12\r\n");
+    esp_at_port_enter_specific(test_wait_data_cb);
+    test_check("AT+BLEINIT\r\n");
+    esp_at_port_exit_specific();
+    TEST_ASSERT(!test_cmd_registered("+BLEINIT"));
+
+    // a name cut by the data mode is not completed by the next command line
+    test_check("AT+BLE");
+    esp_at_port_enter_specific(test_wait_data_cb);
+    esp_at_port_exit_specific();
+    test_check("HIDINIT\r\n");
+    TEST_ASSERT_EQUAL(2, s_lazy_pending_num);
+
+    // the same for the transparent transmission
+    esp_at_cmd_set_lazy_register_status(ESP_AT_STATUS_TRANSMIT);
+    test_check("AT+BLEINIT\r\n");
+    TEST_ASSERT(!test_cmd_registered("+BLEINIT"));
+    esp_at_cmd_set_lazy_register_status(ESP_AT_STATUS_NORMAL);
+    test_check("AT+BLEINIT\r\n");
+    TEST_ASSERT(test_cmd_registered("+BLEINIT"));
+}
+
+int main(void)
+{
+    RUN_TEST(test_cmd_register_order);
+    RUN_TEST(test_cmd_register_chunks);
+    RUN_TEST(test_cmd_register_cmd_list);
+    RUN_TEST(test_cmd_register_data_mode);
+    return TEST_RESULT();
+}
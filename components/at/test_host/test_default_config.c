@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+#include "esp_attr.h"
+#include "at_default_config.c"
+
+#define TEST_BUILTIN_MODULE_NUM 2
+#define TEST_EXTRA_BASE_ID     (TEST_BUILTIN_MODULE_NUM + 2)
+#define TEST_EXTRA_MODULE_NUM   300
+
+// the modules an application adds, which get their ids in the order of the tags
+ESP_AT_MODULE_INFO_DEFINE(test_b, "TEST-B", "test-b-token", "test-b-ssl-token");
+ESP_AT_MODULE_INFO_DEFINE(test_a, "TEST-A", NULL, NULL);
+
+// plenty of more modules, to have ids beyond 255, the last one reuses a built-in name;
+// an array of 16 bytes or more is aligned to 16 by the x86-64 abi, which may leave a hole after the other modules
+static char s_extra_names[TEST_EXTRA_MODULE_NUM][16];
+static AT_MODULE_INFO_ATTR(test_c) __attribute__((aligned(sizeof(void *)))) at_module_info_t s_extra_modules[TEST_EXTRA_MODULE_NUM + 1];
+
+static at_mfg_params_t s_mfg_params;
+
+const at_mfg_params_t *at_get_mfg_params(void)
+{
+    return &s_mfg_params;
+}
+
+static void test_module_setup(void)
+{
+    for (int i = 0; i < TEST_EXTRA_MODULE_NUM; i++) {
+        snprintf(s_extra_names[i], sizeof(s_extra_names[i]), "TEST-%03d", i);
+        s_extra_modules[i].module_name = s_extra_names[i];
+        s_extra_modules[i].ota_token = (i % 2) ? s_extra_names[i] : NULL;
+    }
+    s_extra_modules[TEST_EXTRA_MODULE_NUM].module_name = "MINI-1";
+}
+
+static void test_module_builtin_lookup(void)
+{
+    TEST_ASSERT_EQUAL(TEST_EXTRA_BASE_ID + TEST_EXTRA_MODULE_NUM + 1, at_module_info_num());
+
+    esp_at_set_module_id_by_str("ESP32C3-SPI");
+    TEST_ASSERT_EQUAL(1, esp_at_get_module_id());
+    TEST_ASSERT_EQUAL_STRING("ESP32C3-SPI", esp_at_get_current_module_name());
+
+    // the first module with a name wins, as with the linear search
+    esp_at_set_module_id_by_str("MINI-1");
+    TEST_ASSERT_EQUAL(0, esp_at_get_module_id());
+}
+
+static void test_module_defined_lookup(void)
+{
+    // the ids follow the built-in modules, sorted by the tags rather than the definition order
+    esp_at_set_module_id_by_str("TEST-A");
+    TEST_ASSERT_EQUAL(TEST_BUILTIN_MODULE_NUM, esp_at_get_module_id());
+    TEST_ASSERT(esp_at_get_ota_token_by_id(TEST_BUILTIN_MODULE_NUM, ESP_AT_OTA_MODE_NORMAL) == NULL);
+
+    esp_at_set_module_id_by_str("TEST-B");
+    TEST_ASSERT_EQUAL(TEST_BUILTIN_MODULE_NUM + 1, esp_at_get_module_id());
+    TEST_ASSERT_EQUAL_STRING("test-b-token", esp_at_get_ota_token_by_id(TEST_BUILTIN_MODULE_NUM + 1, ESP_AT_OTA_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_STRING("test-b-ssl-token", esp_at_get_ota_token_by_id(TEST_BUILTIN_MODULE_NUM + 1, ESP_AT_OTA_MODE_SSL));
+}
+
+static void test_module_extra_lookup(void)
+{
+    // every module is found through the hashed index, including the ids beyond 255
+    for (int i = 0; i < TEST_EXTRA_MODULE_NUM; i++) {
+        esp_at_set_module_id_by_str(s_extra_names[i]);
+        TEST_ASSERT_EQUAL(TEST_EXTRA_BASE_ID + i, esp_at_get_module_id());
+        TEST_ASSERT_EQUAL_STRING(s_extra_names[i], esp_at_get_current_module_name());
+    }
+    TEST_ASSERT(s_module_index != NULL);
+    TEST_ASSERT(s_module_index_size >= 2 * at_module_info_num());
+
+    esp_at_set_module_id(TEST_EXTRA_BASE_ID + 299);
+    TEST_ASSERT_EQUAL_STRING("TEST-299", esp_at_get_current_module_name());
+    TEST_ASSERT_EQUAL_STRING("TEST-299", esp_at_get_ota_token_by_id(TEST_EXTRA_BASE_ID + 299, ESP_AT_OTA_MODE_NORMAL));
+    TEST_ASSERT(esp_at_get_ota_token_by_id(TEST_EXTRA_BASE_ID + 298, ESP_AT_OTA_MODE_NORMAL) == NULL);
+}
+
+static void test_module_unknown(void)
+{
+    esp_at_set_module_id_by_str("TEST-123");
+    esp_at_set_module_id_by_str("NO-SUCH-MODULE");
+    TEST_ASSERT_EQUAL(TEST_EXTRA_BASE_ID + 123, esp_at_get_module_id());
+
+    esp_at_set_module_id(at_module_info_num());
+    TEST_ASSERT_EQUAL_STRING(ESP_AT_UNKNOWN_STR, esp_at_get_current_module_name());
+    TEST_ASSERT_EQUAL_STRING(ESP_AT_UNKNOWN_STR, esp_at_get_ota_token_by_id(at_module_info_num(), ESP_AT_OTA_MODE_NORMAL));
+}
+
+static void test_sys_tune_defaults(void)
+{
+    // zero means not tuned
+    memset(&s_mfg_params, 0, sizeof(s_mfg_params));
+    TEST_ASSERT_EQUAL(CONFIG_AT_PROCESS_TASK_STACK_SIZE, esp_at_get_process_task_stack_size());
+    TEST_ASSERT_EQUAL(CONFIG_AT_SOCKET_TASK_STACK_SIZE, esp_at_get_socket_task_stack_size());
+    TEST_ASSERT_EQUAL(CONFIG_AT_SOCKET_MAX_CONN_NUM, esp_at_get_netconn_max_count());
+    TEST_ASSERT_EQUAL(CONFIG_AT_HTTP_TX_BUFFER_SIZE, esp_at_get_http_tx_buffer_size());
+    TEST_ASSERT_EQUAL(CONFIG_AT_HTTP_RX_BUFFER_SIZE, esp_at_get_http_rx_buffer_size());
+}
+
+static void test_sys_tune_clamps(void)
+{
+    at_sys_tune_t *tune = &s_mfg_params.sys_tune;
+
+    tune->process_task_stack_size = 8192;
+    tune->socket_task_stack_size = 1;
+    tune->netconn_max_count = 3;
+    tune->http_tx_buffer_size = 100;
+    tune->http_rx_buffer_size = 1024 * 1024;
+    TEST_ASSERT_EQUAL(8192, esp_at_get_process_task_stack_size());
+    TEST_ASSERT_EQUAL(AT_SYS_TUNE_STACK_SIZE_MIN, esp_at_get_socket_task_stack_size());
+    TEST_ASSERT_EQUAL(3, esp_at_get_netconn_max_count());
+    TEST_ASSERT_EQUAL(AT_SYS_TUNE_BUFFER_SIZE_MIN, esp_at_get_http_tx_buffer_size());
+    TEST_ASSERT_EQUAL(AT_SYS_TUNE_BUFFER_SIZE_MAX, esp_at_get_http_rx_buffer_size());
+
+    // the lwip resources are sized at compile time, so the count cannot grow
+    tune->process_task_stack_size = 0xFFFFFFFF;
+    tune->netconn_max_count = CONFIG_AT_SOCKET_MAX_CONN_NUM + 1;
+    TEST_ASSERT_EQUAL(AT_SYS_TUNE_STACK_SIZE_MAX, esp_at_get_process_task_stack_size());
+    TEST_ASSERT_EQUAL(CONFIG_AT_SOCKET_MAX_CONN_NUM, esp_at_get_netconn_max_count());
+}
+
+int main(void)
+{
+    test_module_setup();
+    RUN_TEST(test_module_builtin_lookup);
+    RUN_TEST(test_module_defined_lookup);
+    RUN_TEST(test_module_extra_lookup);
+    RUN_TEST(test_module_unknown);
+    RUN_TEST(test_sys_tune_defaults);
+    RUN_TEST(test_sys_tune_clamps);
+    return TEST_RESULT();
+}
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Minimal assertions of the host tests. A failed assertion is reported and the test goes on,
+ *        the test program returns non-zero if any assertion failed.
+ */
+static int s_test_failures;
+
+#define TEST_ASSERT(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #cond); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL(expected, actual) \
+    do { \
+        long long _e = (long long)(expected), _a = (long long)(actual); \
+        if (_e != _a) { \
+            printf("%s:%d: %s expected %lld, got %lld\n", __FILE__, __LINE__, #actual, _e, _a); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL_STRING(expected, actual) \
+    do { \
+        const char *_e = (expected), *_a = (actual); \
+        if (!_a || strcmp(_e, _a) != 0) { \
+            printf("%s:%d: %s expected \"%s\", got \"%s\"\n", __FILE__, __LINE__, #actual, _e, _a ? _a : "(null)"); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL_MEMORY(expected, actual, len) \
+    do { \
+        if (memcmp((expected), (actual), (len)) != 0) { \
+            printf("%s:%d: %s differs from %s\n", __FILE__, __LINE__, #actual, #expected); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define RUN_TEST(fn) \
+    do { \
+        printf("%s\n", #fn); \
+        fn(); \
+    } while (0)
+
+#define TEST_RESULT()   (s_test_failures ? 1 : 0)
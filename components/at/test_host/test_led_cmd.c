@@ -0,0 +1,569 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+
+#include "at_led_cmd.c"
+#include "mock.h"
+#include "mock_at.h"
+
+// the RMT driver, the transmitted frames are kept for the tests
+static rmt_encode_simple_cb_t s_rmt_encode_cb;
+static uint8_t s_rmt_tx_data[MAX_LED_NUMBERS * LED_MAX_CHANNELS];
+static size_t s_rmt_tx_len;
+static int s_rmt_tx_num;
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *ret_chan)
+{
+    static int chan;
+    *ret_chan = (rmt_channel_handle_t)&chan;
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_simple_encoder(const rmt_simple_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    static int encoder;
+    s_rmt_encode_cb = config->callback;
+    *ret_encoder = (rmt_encoder_handle_t)&encoder;
+    return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t channel)
+{
+    return ESP_OK;
+}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload, size_t payload_bytes,
+                       const rmt_transmit_config_t *config)
+{
+    memcpy(s_rmt_tx_data, payload, payload_bytes);
+    s_rmt_tx_len = payload_bytes;
+    s_rmt_tx_num++;
+    return ESP_OK;
+}
+
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t channel, int timeout_ms)
+{
+    // every frame takes 2 ms on the wire
+    mock_tick += 2;
+    return ESP_OK;
+}
+
+static uint8_t test_setup_cmd(uint8_t (*setup)(uint8_t), int num, const char *const *paras)
+{
+    mock_at_set_paras(num, paras);
+    return setup(num);
+}
+
+static uint8_t test_setup_cmd_with_data(uint8_t (*setup)(uint8_t), int num, const char *const *paras, const void *data, int32_t len)
+{
+    mock_at_set_input(data, len);
+    return test_setup_cmd(setup, num, paras);
+}
+
+static const uint8_t *test_led_rgb(unsigned int led)
+{
+    return &led_strip_pixels[led * 3];
+}
+
+static void test_led_reset(void)
+{
+    mock_freertos_reset();
+    mock_tick = 1;
+    mock_at_reset();
+    memset(led_strip_pixels, 0, sizeof(led_strip_pixels));
+    led_used_no = 0;
+    led_pending_count = 0;
+    led_frames_sent = 0;
+    led_frames_dropped = 0;
+    led_format = LED_FORMAT_RGB332;
+    led_order = LED_ORDER_GRB;
+    led_brightness = 255;
+    led_gamma = LED_GAMMA_DEFAULT;
+    memset(&led_anim, 0, sizeof(led_anim));
+    for (int i = 0; i < LED_ANIM_KEYFRAME_NUM; i++) {
+        free(led_keyframes[i].rgb);
+        led_keyframes[i].rgb = NULL;
+    }
+    s_rmt_tx_len = 0;
+    s_rmt_tx_num = 0;
+
+    // the strip is cleared at init, the tests start from an unused strip
+    at_led_init();
+    led_used_no = 0;
+    led_pending_count = 0;
+    led_flush_task->notify_count = 0;
+}
+
+static void test_led_frame_decode(void)
+{
+    uint8_t hex[] = "0aFf7C";
+    TEST_ASSERT_EQUAL(3, at_led_frame_decode(hex, 6, LED_FRAME_MODE_HEX));
+    TEST_ASSERT_EQUAL_MEMORY("\x0a\xff\x7c", hex, 3);
+
+    uint8_t odd[] = "0af";
+    TEST_ASSERT_EQUAL(-1, at_led_frame_decode(odd, 3, LED_FRAME_MODE_HEX));
+    uint8_t bad[] = "0g";
+    TEST_ASSERT_EQUAL(-1, at_led_frame_decode(bad, 2, LED_FRAME_MODE_HEX));
+
+    // binary payloads are taken as they are
+    uint8_t bin[] = {0x00, 0x30, 0xff};
+    TEST_ASSERT_EQUAL(3, at_led_frame_decode(bin, 3, LED_FRAME_MODE_BINARY));
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x30\xff", bin, 3);
+}
+
+static void test_ledframe_partial_update(void)
+{
+    test_led_reset();
+
+    // RGB332 pixels: white, red, blue
+    const char *const full[] = {"3"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd_with_data(at_setup_cmd_ledframe, 1, full, "\xff\xe0\x03", 3));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT, mock_at_last_result);
+    TEST_ASSERT_EQUAL_MEMORY("\xff\xff\xff", test_led_rgb(0), 3);
+    TEST_ASSERT_EQUAL_MEMORY("\xff\x00\x00", test_led_rgb(1), 3);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\xff", test_led_rgb(2), 3);
+    TEST_ASSERT_EQUAL(3, led_pending_count);
+
+    // hex pixels from LED 4 on: the LEDs in front keep their values and are sent again, LED 3 is off
+    const char *const window[] = {"4", "4", "1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd_with_data(at_setup_cmd_ledframe, 3, window, "1c00", 4));
+    TEST_ASSERT_EQUAL_MEMORY("\xff\xff\xff", test_led_rgb(0), 3);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\x00", test_led_rgb(3), 3);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\xff\x00", test_led_rgb(4), 3);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\x00", test_led_rgb(5), 3);
+    TEST_ASSERT_EQUAL(6, led_pending_count);
+    TEST_ASSERT_EQUAL(6, led_used_no);
+}
+
+static void test_ledframe_invalid(void)
+{
+    test_led_reset();
+
+    // past the end of the strip
+    const char *const overflow[] = {"2", "255"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledframe, 2, overflow));
+    // odd hex length, and a length which is not a whole number of pixels
+    const char *const odd_hex[] = {"3", "0", "1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledframe, 3, odd_hex));
+    led_format = LED_FORMAT_RGB565;
+    const char *const half_pixel[] = {"3"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledframe, 1, half_pixel));
+    // an unknown mode
+    const char *const mode[] = {"2", "0", "2"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledframe, 3, mode));
+    TEST_ASSERT(mock_at_last_result != ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT);
+
+    // a malformed hex payload is received, then rejected without touching the strip
+    led_format = LED_FORMAT_RGB332;
+    const char *const hex[] = {"2", "0", "1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd_with_data(at_setup_cmd_ledframe, 3, hex, "zz", 2));
+    TEST_ASSERT_EQUAL(0, led_used_no);
+    TEST_ASSERT_EQUAL(0, led_pending_count);
+}
+
+static void test_led_para_limit(void)
+{
+    test_led_reset();
+
+    const char *paras[ESP_AT_PARA_NUM_MAX + 1];
+    for (int i = 0; i <= ESP_AT_PARA_NUM_MAX; i++) {
+        paras[i] = "255";
+    }
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_led, ESP_AT_PARA_NUM_MAX + 1, paras));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_led, ESP_AT_PARA_NUM_MAX, paras));
+    TEST_ASSERT_EQUAL(ESP_AT_PARA_NUM_MAX, led_pending_count);
+
+    // a pixel value beyond the format
+    const char *const big[] = {"256"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_led, 1, big));
+}
+
+static void test_led_flush_swap(void)
+{
+    test_led_reset();
+    TaskHandle_t flush_task = mock_task_find("led_flush");
+
+    // RGB332 white and blue, sent in GRB order
+    const char *const frame[] = {"255", "3"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_led, 2, frame));
+    TEST_ASSERT_EQUAL(1, flush_task->notify_count);
+    TEST_ASSERT_EQUAL(0, s_rmt_tx_num);
+
+    at_led_flush_frame();
+    TEST_ASSERT_EQUAL(1, s_rmt_tx_num);
+    TEST_ASSERT_EQUAL(6, s_rmt_tx_len);
+    TEST_ASSERT_EQUAL_MEMORY("\xff\xff\xff\x00\x00\xff", s_rmt_tx_data, 6);
+    TEST_ASSERT_EQUAL(0, led_pending_count);
+
+    // the commands write the back buffer while the front buffer is on the wire
+    const char *const next[] = {"224"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_led, 1, next));
+    TEST_ASSERT_EQUAL_MEMORY("\xff\xff\xff\x00\x00\xff", led_tx_pixels, 6);
+    at_led_flush_frame();
+    TEST_ASSERT_EQUAL(2, s_rmt_tx_num);
+    TEST_ASSERT_EQUAL(3, s_rmt_tx_len);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\xff\x00", s_rmt_tx_data, 3);
+
+    // nothing is sent without a pending frame
+    at_led_flush_frame();
+    TEST_ASSERT_EQUAL(2, s_rmt_tx_num);
+}
+
+static void test_led_flush_drop(void)
+{
+    test_led_reset();
+
+    // a frame superseded before the flush task takes it is dropped, the latest one is sent
+    const char *const first[] = {"255", "255"};
+    const char *const second[] = {"3"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_led, 2, first));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_led, 1, second));
+    at_led_flush_frame();
+    at_led_flush_frame();
+    TEST_ASSERT_EQUAL(1, s_rmt_tx_num);
+    TEST_ASSERT_EQUAL(3, s_rmt_tx_len);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\xff", s_rmt_tx_data, 3);
+
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_led((uint8_t *)"+LED"));
+    TEST_ASSERT_EQUAL_STRING("+LED:1,1,2000\r\n", mock_at_output);
+}
+
+// the symbols of a byte encoded bit by bit, MSB first
+static void test_led_encode_reference(uint8_t value, rmt_symbol_word_t symbols[8])
+{
+    for (int bit = 0; bit < 8; bit++) {
+        symbols[bit] = (value & (0x80 >> bit)) ? ws2812_one : ws2812_zero;
+    }
+}
+
+static bool test_led_symbols_match(const uint8_t *data, size_t len, const rmt_symbol_word_t *symbols)
+{
+    for (size_t i = 0; i < len; i++) {
+        rmt_symbol_word_t expected[8];
+        test_led_encode_reference(data[i], expected);
+        for (int bit = 0; bit < 8; bit++) {
+            if (symbols[i * 8 + bit].val != expected[bit].val) {
+                printf("byte %zu bit %d differs\n", i, bit);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_led_encoder_bit_exact(void)
+{
+    test_led_reset();
+    TEST_ASSERT(s_rmt_encode_cb == encoder_callback);
+    TEST_ASSERT(ws2812_one.val != ws2812_zero.val);
+
+    // every byte value in one call, then the reset
+    static uint8_t data[256];
+    static rmt_symbol_word_t symbols[256 * 8 + 1];
+    for (int i = 0; i < 256; i++) {
+        data[i] = i;
+    }
+    bool done = false;
+    TEST_ASSERT_EQUAL(256 * 8 + 1, encoder_callback(data, 256, 0, 256 * 8 + 1, symbols, &done, NULL));
+    TEST_ASSERT(done);
+    TEST_ASSERT(test_led_symbols_match(data, 256, symbols));
+    TEST_ASSERT_EQUAL(ws2812_reset.val, symbols[256 * 8].val);
+}
+
+static void test_led_encoder_chunks(void)
+{
+    test_led_reset();
+
+    const uint8_t data[] = {0xa5, 0x0f, 0xf0};
+    rmt_symbol_word_t symbols[3 * 8 + 1];
+    size_t written = 0;
+    bool done = false;
+
+    // only whole bytes are encoded into the free space
+    TEST_ASSERT_EQUAL(8, encoder_callback(data, 3, written, 15, &symbols[written], &done, NULL));
+    TEST_ASSERT(!done);
+    written += 8;
+
+    // the last byte fills the free space, the reset follows in the next call
+    TEST_ASSERT_EQUAL(16, encoder_callback(data, 3, written, 16, &symbols[written], &done, NULL));
+    TEST_ASSERT(!done);
+    written += 16;
+    TEST_ASSERT_EQUAL(1, encoder_callback(data, 3, written, 64, &symbols[written], &done, NULL));
+    TEST_ASSERT(done);
+
+    TEST_ASSERT(test_led_symbols_match(data, 3, symbols));
+    TEST_ASSERT_EQUAL(ws2812_reset.val, symbols[24].val);
+}
+
+// RGB888 pixels without gamma correction, so the keyframes keep the values sent
+static void test_led_anim_keyframes(void)
+{
+    const char *const cfg[] = {"2", "0", "100"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledcfg, 3, cfg));
+    led_pending_count = 0;
+
+    const char *const key0[] = {"0", "6"};
+    const char *const key1[] = {"1", "6"};
+    const char *const key2[] = {"2", "3", "2"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd_with_data(at_setup_cmd_ledkey, 2, key0, "\x00\x00\x00\xc8\x00\x00", 6));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd_with_data(at_setup_cmd_ledkey, 2, key1, "\xc8\x64\x00\x00\x00\x00", 6));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd_with_data(at_setup_cmd_ledkey, 3, key2, "\x5a\x5a\x5a", 3));
+}
+
+static void test_led_anim_render_at(uint32_t elapsed_ms)
+{
+    mock_tick = 1 + elapsed_ms;
+    at_led_flush_frame();
+}
+
+static void test_led_anim_timeline(void)
+{
+    test_led_reset();
+    test_led_anim_keyframes();
+
+    // fade to keyframe 1 in 1 s, then back to keyframe 0 in 1 s, once
+    const char *const anim[] = {"10", "1", "0", "1", "1000", "0", "1000"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 7, anim));
+
+    // the first step fades from the keyframe of the last step
+    test_led_anim_render_at(0);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\x00\xc8\x00\x00", test_led_rgb(0), 6);
+    test_led_anim_render_at(500);
+    TEST_ASSERT_EQUAL_MEMORY("\x64\x32\x00\x64\x00\x00", test_led_rgb(0), 6);
+    test_led_anim_render_at(1000);
+    TEST_ASSERT_EQUAL_MEMORY("\xc8\x64\x00\x00\x00\x00", test_led_rgb(0), 6);
+    test_led_anim_render_at(1250);
+    TEST_ASSERT_EQUAL_MEMORY("\x96\x4b\x00\x32\x00\x00", test_led_rgb(0), 6);
+    TEST_ASSERT(led_anim.running);
+    TEST_ASSERT_EQUAL(0, mock_at_output_len);
+
+    // the last keyframe stays once the loops are played
+    test_led_anim_render_at(2100);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\x00\xc8\x00\x00", test_led_rgb(0), 6);
+    TEST_ASSERT(!led_anim.running);
+    TEST_ASSERT_EQUAL_STRING("+LEDANIM:DONE\r\n", mock_at_output);
+    // GRB on the wire
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x00\x00\x00\xc8\x00", s_rmt_tx_data, 6);
+
+    // the animation renders nothing more
+    int tx_num = s_rmt_tx_num;
+    test_led_anim_render_at(2200);
+    TEST_ASSERT_EQUAL(tx_num, s_rmt_tx_num);
+}
+
+static void test_led_anim_restart_hook(SemaphoreHandle_t mutex)
+{
+    mock_mutex_give_hook = NULL;
+    const char *const anim[] = {"10", "0", "0", "0", "100"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 5, anim));
+}
+
+static void test_led_anim_done_restart(void)
+{
+    test_led_reset();
+    test_led_anim_keyframes();
+
+    const char *const anim[] = {"10", "1", "0", "1", "100"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 5, anim));
+    test_led_anim_render_at(50);
+    TEST_ASSERT(esp_timer_is_active(led_anim_timer));
+
+    // the AT task starts another animation as soon as the flush task releases the buffers,
+    // which keeps its timer, and the end of the first one is reported before
+    mock_mutex_give_hook = test_led_anim_restart_hook;
+    test_led_anim_render_at(150);
+    TEST_ASSERT(mock_mutex_give_hook == NULL);
+    TEST_ASSERT_EQUAL_STRING("+LEDANIM:DONE\r\n", mock_at_output);
+    TEST_ASSERT(led_anim.running);
+    TEST_ASSERT_EQUAL(0, led_anim.loops);
+    TEST_ASSERT(esp_timer_is_active(led_anim_timer));
+
+    const char *const stop[] = {"0"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 1, stop));
+    TEST_ASSERT(!esp_timer_is_active(led_anim_timer));
+}
+
+static void test_led_anim_window_and_curve(void)
+{
+    test_led_reset();
+    test_led_anim_keyframes();
+
+    // keyframe 2 only covers LED 2, which fades in from off, and repeats forever
+    const char *const anim[] = {"10", "0", "0", "0", "100", "2", "100"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 7, anim));
+    test_led_anim_render_at(150);
+    TEST_ASSERT_EQUAL_MEMORY("\x2d\x2d\x2d", test_led_rgb(2), 3);
+    test_led_anim_render_at(100000 + 150);
+    TEST_ASSERT_EQUAL_MEMORY("\x2d\x2d\x2d", test_led_rgb(2), 3);
+    TEST_ASSERT(led_anim.running);
+
+    // the keyframes in use cannot be replaced, and the animation is stopped by AT+LEDANIM=0
+    const char *const key[] = {"0", "3"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd_with_data(at_setup_cmd_ledkey, 2, key, "\x01\x02\x03", 3));
+    const char *const stop[] = {"0"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 1, stop));
+    TEST_ASSERT(!led_anim.running);
+
+    // a gamma aware fade interpolates the perceived brightness
+    led_gamma = 200;
+    at_led_lut_update();
+    TEST_ASSERT_EQUAL(127, at_led_anim_blend(0, 255, 128, LED_ANIM_CURVE_LINEAR));
+    TEST_ASSERT_EQUAL(63, at_led_anim_blend(0, 255, 128, LED_ANIM_CURVE_GAMMA));
+    TEST_ASSERT_EQUAL(0, at_led_anim_blend(0, 255, 0, LED_ANIM_CURVE_GAMMA));
+    TEST_ASSERT_EQUAL(255, at_led_anim_blend(0, 255, 256, LED_ANIM_CURVE_GAMMA));
+}
+
+static void test_led_anim_invalid(void)
+{
+    test_led_reset();
+    test_led_anim_keyframes();
+
+    // as many steps as the AT core can parse
+    const char *paras[ESP_AT_PARA_NUM_MAX + 2] = {"10", "0", "0"};
+    int num = 3;
+    for (int i = 0; i < LED_ANIM_STEP_NUM + 1; i++) {
+        paras[num++] = "1";
+        paras[num++] = "100";
+    }
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledanim, 3 + LED_ANIM_STEP_NUM * 2, paras));
+    TEST_ASSERT_EQUAL(LED_ANIM_STEP_NUM, led_anim.step_num);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledanim, num, paras));
+
+    // an empty keyframe slot, an unknown curve and a zero step time
+    const char *const empty[] = {"10", "0", "0", "3", "100"};
+    const char *const curve[] = {"10", "0", "2", "0", "100"};
+    const char *const zero[] = {"10", "0", "0", "0", "0"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledanim, 5, empty));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledanim, 5, curve));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledanim, 5, zero));
+}
+
+static void test_led_pixel_formats(void)
+{
+    test_led_reset();
+    uint8_t rgb[3];
+
+    // without gamma correction the channels are expanded to 8 bits as they are
+    led_gamma = 100;
+    at_led_lut_update();
+    led_format = LED_FORMAT_RGB565;
+    at_led_pixel_to_rgb(0xf800, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\xff\x00\x00", rgb, 3);
+    at_led_pixel_to_rgb(0x07e0, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\xff\x00", rgb, 3);
+    at_led_pixel_to_rgb(0x8410, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\x84\x82\x84", rgb, 3);
+    led_format = LED_FORMAT_RGB888;
+    at_led_pixel_to_rgb(0x123456, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\x12\x34\x56", rgb, 3);
+    led_format = LED_FORMAT_GRB888;
+    at_led_pixel_to_rgb(0x123456, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\x34\x12\x56", rgb, 3);
+
+    // RGB332 goes through its own tables whatever the gamma
+    led_format = LED_FORMAT_RGB332;
+    at_led_pixel_to_rgb(0x49, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\x07\x07\x02", rgb, 3);
+
+    // multi-byte pixels are big endian
+    led_format = LED_FORMAT_RGB565;
+    TEST_ASSERT_EQUAL(0x1234, at_led_pixel_from_bytes((const uint8_t *)"\x12\x34\x56"));
+    led_format = LED_FORMAT_RGB888;
+    TEST_ASSERT_EQUAL(0x123456, at_led_pixel_from_bytes((const uint8_t *)"\x12\x34\x56"));
+
+    // the default gamma of 2.2, and its inverse
+    led_gamma = LED_GAMMA_DEFAULT;
+    at_led_lut_update();
+    TEST_ASSERT_EQUAL(0, led_gamma_lut[0]);
+    TEST_ASSERT_EQUAL(56, led_gamma_lut[128]);
+    TEST_ASSERT_EQUAL(255, led_gamma_lut[255]);
+    TEST_ASSERT_EQUAL(128, led_degamma_lut[56]);
+    at_led_pixel_to_rgb(0x80ff00, rgb);
+    TEST_ASSERT_EQUAL_MEMORY("\x38\xff\x00", rgb, 3);
+}
+
+static void test_led_output_order_and_brightness(void)
+{
+    test_led_reset();
+    at_led_set_value(0, 200, 100, 50);
+
+    led_order = LED_ORDER_GRB;
+    TEST_ASSERT_EQUAL(3, at_led_output_convert(1));
+    TEST_ASSERT_EQUAL_MEMORY("\x64\xc8\x32", led_tx_pixels, 3);
+    led_order = LED_ORDER_RGB;
+    TEST_ASSERT_EQUAL(3, at_led_output_convert(1));
+    TEST_ASSERT_EQUAL_MEMORY("\xc8\x64\x32", led_tx_pixels, 3);
+
+    // the white channel takes the common part of the three colours
+    led_order = LED_ORDER_GRBW;
+    TEST_ASSERT_EQUAL(4, at_led_output_convert(1));
+    TEST_ASSERT_EQUAL_MEMORY("\x32\x96\x00\x32", led_tx_pixels, 4);
+
+    // the brightness scales the output, not the stored frame
+    led_brightness = 128;
+    at_led_lut_update();
+    led_order = LED_ORDER_RGB;
+    TEST_ASSERT_EQUAL(3, at_led_output_convert(1));
+    TEST_ASSERT_EQUAL_MEMORY("\x64\x32\x19", led_tx_pixels, 3);
+    TEST_ASSERT_EQUAL_MEMORY("\xc8\x64\x32", test_led_rgb(0), 3);
+}
+
+static void test_ledcfg(void)
+{
+    test_led_reset();
+    at_led_set_value(0, 255, 0, 0);
+
+    // a new brightness resends the current frame
+    const char *const cfg[] = {"1", "2", "180", "64"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledcfg, 4, cfg));
+    TEST_ASSERT_EQUAL(1, led_pending_count);
+    TEST_ASSERT_EQUAL(64, led_bright_lut[255]);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_ledcfg((uint8_t *)"+LEDCFG"));
+    TEST_ASSERT_EQUAL_STRING("+LEDCFG:1,2,180,64\r\n", mock_at_output);
+
+    // the omitted parameters are kept
+    const char *const format[] = {"2"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_ledcfg, 1, format));
+    TEST_ASSERT_EQUAL(LED_ORDER_GRBW, led_order);
+    TEST_ASSERT_EQUAL(180, led_gamma);
+    TEST_ASSERT_EQUAL(64, led_brightness);
+
+    // the pixel values of AT+LED are bounded by the format
+    const char *const max[] = {"16777215"};
+    const char *const over[] = {"16777216"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_led, 1, max));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_led, 1, over));
+
+    const char *const bad_format[] = {"4"};
+    const char *const bad_order[] = {"0", "3"};
+    const char *const bad_gamma[] = {"0", "0", "99"};
+    const char *const bad_brightness[] = {"0", "0", "220", "256"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledcfg, 1, bad_format));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledcfg, 2, bad_order));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledcfg, 3, bad_gamma));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_ledcfg, 4, bad_brightness));
+    TEST_ASSERT_EQUAL(LED_FORMAT_RGB888, led_format);
+}
+
+int main(void)
+{
+    RUN_TEST(test_led_frame_decode);
+    RUN_TEST(test_ledframe_partial_update);
+    RUN_TEST(test_ledframe_invalid);
+    RUN_TEST(test_led_para_limit);
+    RUN_TEST(test_led_flush_swap);
+    RUN_TEST(test_led_flush_drop);
+    RUN_TEST(test_led_encoder_bit_exact);
+    RUN_TEST(test_led_encoder_chunks);
+    RUN_TEST(test_led_anim_timeline);
+    RUN_TEST(test_led_anim_done_restart);
+    RUN_TEST(test_led_anim_window_and_curve);
+    RUN_TEST(test_led_anim_invalid);
+    RUN_TEST(test_led_pixel_formats);
+    RUN_TEST(test_led_output_order_and_brightness);
+    RUN_TEST(test_ledcfg);
+    return TEST_RESULT();
+}
@@ -0,0 +1,267 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+
+#include "at_init.c"
+#include "mock.h"
+#include "mock_at.h"
+#include "mock_nvs.h"
+
+// the layout of the legacy factory_param partition, as written by tools/at.py modify_bin
+#define TEST_PARAM_VERSION      2
+#define TEST_PARAM_MODULE_ID    3
+#define TEST_PARAM_TX_POWER     4
+#define TEST_PARAM_UART_PORT    5
+#define TEST_PARAM_START_CHAN   6
+#define TEST_PARAM_END_CHAN     7
+#define TEST_PARAM_COUNTRY      8
+#define TEST_PARAM_BAUDRATE     12
+#define TEST_PARAM_TX_PIN       16
+#define TEST_PARAM_RX_PIN       17
+#define TEST_PARAM_CTS_PIN      18
+#define TEST_PARAM_RTS_PIN      19
+#define TEST_PARAM_MODULE_NAME  56
+#define TEST_PARAM_SIZE         88
+
+void at_interface_init(void)
+{
+}
+
+void at_interface_start(void)
+{
+}
+
+void esp_at_module_init(const uint8_t *custom_version)
+{
+}
+
+void esp_at_cmd_set_register(void)
+{
+}
+
+void esp_at_set_module_id(uint32_t id)
+{
+}
+
+void esp_at_set_module_id_by_str(const char *buffer)
+{
+}
+
+const char *esp_at_get_current_module_name(void)
+{
+    return "";
+}
+
+esp_err_t esp_at_nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return nvs_get_str(handle, key, out_value, length);
+}
+
+// an erased partition, with the magic and the version of the parameters
+static void test_param_image_init(uint8_t *image, uint8_t version)
+{
+    memset(image, 0xff, TEST_PARAM_SIZE);
+    image[0] = 0xfc;
+    image[1] = 0xfc;
+    image[TEST_PARAM_VERSION] = version;
+}
+
+static void test_mfg_params_load_nvs(const mock_nvs_entry_t *entries, int num)
+{
+    mock_nvs_set_factory_param_partition(NULL, 0);
+    mock_nvs_set_entries(entries, num);
+    at_nvs_flash_init_partition();
+}
+
+static void test_mfg_params_load_partition(const uint8_t *image)
+{
+    mock_nvs_set_factory_param_partition(image, TEST_PARAM_SIZE);
+    at_nvs_flash_init_partition();
+    mock_nvs_set_factory_param_partition(NULL, 0);
+}
+
+static void test_mfg_params_nvs_full(void)
+{
+    // the factory_param namespace of the default factory_param_data.csv of tools/at.py
+    static const mock_nvs_entry_t entries[] = {
+        {"factory_param", "module_name", "MINI-1"},
+        {"factory_param", "max_tx_power", "78"},
+        {"factory_param", "uart_port", "1"},
+        {"factory_param", "start_channel", "1"},
+        {"factory_param", "channel_num", "13"},
+        {"factory_param", "country_code", "CN"},
+        {"factory_param", "uart_baudrate", "115200"},
+        {"factory_param", "uart_tx_pin", "7"},
+        {"factory_param", "uart_rx_pin", "6"},
+        {"factory_param", "uart_cts_pin", "5"},
+        {"factory_param", "uart_rts_pin", "4"},
+    };
+    test_mfg_params_load_nvs(entries, sizeof(entries) / sizeof(entries[0]));
+    const at_mfg_params_t *params = at_get_mfg_params();
+
+    TEST_ASSERT_EQUAL(AT_PARAMS_IN_MFG_NVS, params->mode);
+    TEST_ASSERT(params->loaded);
+    TEST_ASSERT(params->module_valid && !params->module_by_id);
+    TEST_ASSERT_EQUAL_STRING("MINI-1", params->module_name);
+    TEST_ASSERT(params->tx_power_valid);
+    TEST_ASSERT_EQUAL(78, params->tx_power);
+    TEST_ASSERT(params->country_valid);
+    TEST_ASSERT_EQUAL(1, params->country_schan);
+    TEST_ASSERT_EQUAL(13, params->country_nchan);
+    TEST_ASSERT_EQUAL_MEMORY("CN\0", params->country_cc, 3);
+    TEST_ASSERT(params->uart_baudrate_valid);
+    TEST_ASSERT_EQUAL(115200, params->uart_baudrate);
+    TEST_ASSERT(params->uart_pins_valid);
+    TEST_ASSERT_EQUAL(1, params->uart_port);
+    TEST_ASSERT_EQUAL(7, params->uart_tx_pin);
+    TEST_ASSERT_EQUAL(6, params->uart_rx_pin);
+    TEST_ASSERT_EQUAL(5, params->uart_cts_pin);
+    TEST_ASSERT_EQUAL(4, params->uart_rts_pin);
+    TEST_ASSERT_EQUAL(-1, params->sys_tune.intf_task_core_id);
+}
+
+static void test_mfg_params_nvs_partial(void)
+{
+    // a country code without its channels, and uart pins without the rts pin
+    static const mock_nvs_entry_t entries[] = {
+        {"factory_param", "module_name", "WROOM-32"},
+        {"factory_param", "country_code", "US"},
+        {"factory_param", "start_channel", "1"},
+        {"factory_param", "uart_port", "1"},
+        {"factory_param", "uart_tx_pin", "7"},
+        {"factory_param", "uart_rx_pin", "6"},
+        {"factory_param", "uart_cts_pin", "5"},
+        {"sys_tune", "intf_core", "0"},
+    };
+    test_mfg_params_load_nvs(entries, sizeof(entries) / sizeof(entries[0]));
+    const at_mfg_params_t *params = at_get_mfg_params();
+
+    TEST_ASSERT(params->loaded);
+    TEST_ASSERT(params->module_valid);
+    TEST_ASSERT_EQUAL_STRING("WROOM-32", params->module_name);
+    TEST_ASSERT(!params->tx_power_valid);
+    TEST_ASSERT(!params->country_valid);
+    TEST_ASSERT(!params->uart_baudrate_valid);
+    TEST_ASSERT(!params->uart_pins_valid);
+    TEST_ASSERT_EQUAL(0, params->sys_tune.intf_task_core_id);
+
+    // without the factory_param namespace nothing is loaded, and the wifi config stays in flash
+    static const mock_nvs_entry_t tune_only[] = {
+        {"sys_tune", "proc_stack", "8192"},
+    };
+    test_mfg_params_load_nvs(tune_only, sizeof(tune_only) / sizeof(tune_only[0]));
+    params = at_get_mfg_params();
+    TEST_ASSERT_EQUAL(AT_PARAMS_IN_MFG_NVS, params->mode);
+    TEST_ASSERT(!params->loaded);
+    TEST_ASSERT(!params->module_valid);
+    TEST_ASSERT_EQUAL(8192, params->sys_tune.process_task_stack_size);
+    TEST_ASSERT_EQUAL(-1, params->uart_port);
+    TEST_ASSERT_EQUAL(ESP_FAIL, at_module_config_init());
+}
+
+static void test_mfg_params_partition_full(void)
+{
+    uint8_t image[TEST_PARAM_SIZE];
+    test_param_image_init(image, 3);
+    image[TEST_PARAM_TX_POWER] = 78;
+    image[TEST_PARAM_UART_PORT] = 1;
+    image[TEST_PARAM_START_CHAN] = 1;
+    image[TEST_PARAM_END_CHAN] = 11;
+    memcpy(&image[TEST_PARAM_COUNTRY], "US\0\0", 4);
+    int32_t baudrate = 921600;
+    memcpy(&image[TEST_PARAM_BAUDRATE], &baudrate, sizeof(baudrate));
+    image[TEST_PARAM_TX_PIN] = 7;
+    image[TEST_PARAM_RX_PIN] = 6;
+    image[TEST_PARAM_CTS_PIN] = 5;
+    image[TEST_PARAM_RTS_PIN] = 4;
+    // a name which fills its field is followed by the 0xff padding, not by a terminator
+    memcpy(&image[TEST_PARAM_MODULE_NAME], "0123456789abcdef0123456789ABCDEF", 32);
+
+    test_mfg_params_load_partition(image);
+    const at_mfg_params_t *params = at_get_mfg_params();
+
+    TEST_ASSERT_EQUAL(AT_PARAMS_IN_PARTITION, params->mode);
+    TEST_ASSERT(params->loaded);
+    TEST_ASSERT(params->module_valid && !params->module_by_id);
+    TEST_ASSERT_EQUAL_STRING("0123456789abcdef0123456789ABCDEF", params->module_name);
+    TEST_ASSERT(params->tx_power_valid);
+    TEST_ASSERT_EQUAL(78, params->tx_power);
+    TEST_ASSERT(params->country_valid);
+    TEST_ASSERT_EQUAL(1, params->country_schan);
+    TEST_ASSERT_EQUAL(11, params->country_nchan);
+    TEST_ASSERT_EQUAL_MEMORY("US\0", params->country_cc, 3);
+    TEST_ASSERT(params->uart_baudrate_valid);
+    TEST_ASSERT_EQUAL(921600, params->uart_baudrate);
+    TEST_ASSERT(params->uart_pins_valid);
+    TEST_ASSERT_EQUAL(1, params->uart_port);
+    TEST_ASSERT_EQUAL(7, params->uart_tx_pin);
+    TEST_ASSERT_EQUAL(6, params->uart_rx_pin);
+    TEST_ASSERT_EQUAL(5, params->uart_cts_pin);
+    TEST_ASSERT_EQUAL(4, params->uart_rts_pin);
+}
+
+static void test_mfg_params_partition_partial(void)
+{
+    uint8_t image[TEST_PARAM_SIZE];
+    const at_mfg_params_t *params = at_get_mfg_params();
+
+    // version 1 stores a module id, and a tx power below 10 is not a valid value there;
+    // the unset fields are left erased
+    test_param_image_init(image, 1);
+    image[TEST_PARAM_MODULE_ID] = 2;
+    image[TEST_PARAM_TX_POWER] = 8;
+    test_mfg_params_load_partition(image);
+    TEST_ASSERT(params->loaded);
+    TEST_ASSERT(params->module_valid && params->module_by_id);
+    TEST_ASSERT_EQUAL(2, params->module_id);
+    TEST_ASSERT(!params->tx_power_valid);
+    TEST_ASSERT(!params->country_valid);
+    TEST_ASSERT(!params->uart_baudrate_valid);
+    TEST_ASSERT(params->uart_pins_valid);
+    TEST_ASSERT_EQUAL(-1, params->uart_port);
+    TEST_ASSERT_EQUAL(-1, params->uart_tx_pin);
+    TEST_ASSERT_EQUAL(-1, params->uart_rx_pin);
+    TEST_ASSERT_EQUAL(-1, params->uart_cts_pin);
+    TEST_ASSERT_EQUAL(-1, params->uart_rts_pin);
+
+    // the same tx power is valid from version 2 on, but a channel range which ends before it starts is not
+    test_param_image_init(image, 2);
+    image[TEST_PARAM_TX_POWER] = 8;
+    image[TEST_PARAM_START_CHAN] = 6;
+    image[TEST_PARAM_END_CHAN] = 5;
+    memcpy(&image[TEST_PARAM_COUNTRY], "JP\0\0", 4);
+    test_mfg_params_load_partition(image);
+    TEST_ASSERT(params->tx_power_valid);
+    TEST_ASSERT_EQUAL(8, params->tx_power);
+    TEST_ASSERT(!params->country_valid);
+
+    image[TEST_PARAM_START_CHAN] = 0;
+    image[TEST_PARAM_END_CHAN] = 14;
+    test_mfg_params_load_partition(image);
+    TEST_ASSERT(!params->country_valid);
+    image[TEST_PARAM_START_CHAN] = 1;
+    image[TEST_PARAM_END_CHAN] = 15;
+    test_mfg_params_load_partition(image);
+    TEST_ASSERT(!params->country_valid);
+
+    // without the magic nothing is loaded
+    test_param_image_init(image, 3);
+    image[1] = 0xfd;
+    test_mfg_params_load_partition(image);
+    TEST_ASSERT_EQUAL(AT_PARAMS_IN_PARTITION, params->mode);
+    TEST_ASSERT(!params->loaded);
+    TEST_ASSERT(!params->module_valid);
+    TEST_ASSERT_EQUAL(-1, params->uart_port);
+}
+
+int main(void)
+{
+    RUN_TEST(test_mfg_params_nvs_full);
+    RUN_TEST(test_mfg_params_nvs_partial);
+    RUN_TEST(test_mfg_params_partition_full);
+    RUN_TEST(test_mfg_params_partition_partial);
+    return TEST_RESULT();
+}
@@ -0,0 +1,398 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+
+#define CONFIG_AT_SYSMON_COMMAND_SUPPORT    1
+#define CONFIG_AT_SYSCPU_COMMAND_SUPPORT    1
+#define CONFIG_AT_ALLOC_FAIL_RECORD_SUPPORT 1
+#include "at_sysmon_cmd.c"
+#include "mock.h"
+#include "mock_at.h"
+
+static uint8_t test_setup_cmd(uint8_t (*setup)(uint8_t), int num, const char *const *paras)
+{
+    mock_at_set_paras(num, paras);
+    return setup(num);
+}
+
+static void test_sysmon_reset(void)
+{
+    mock_freertos_reset();
+    mock_tick = 1;
+    mock_at_reset();
+    s_sysmon_task = NULL;
+    s_sysmon_interval = 0;
+    s_syscpu_task = NULL;
+    s_syscpu_window_ms = 1000;
+    s_syscpu_interval = 0;
+    s_syscpu_oneshot_window_ms = 0;
+}
+
+static void test_sysmon_report_format(void)
+{
+    test_sysmon_reset();
+    mock_task_status[0] = (TaskStatus_t) {
+        .pcTaskName = "at", .uxCurrentPriority = 3, .usStackHighWaterMark = 1024,
+    };
+    mock_task_status_num = 1;
+
+    at_sysmon_report_heap("+SYSMON", esp_at_port_active_write_data);
+    at_sysmon_report_tasks("+SYSMON", esp_at_port_active_write_data);
+    TEST_ASSERT_EQUAL_STRING("+SYSMON:HEAP,\"internal\",100000,80000,60000\r\n"
+                             "+SYSMON:HEAP,\"dma\",100000,80000,60000\r\n"
+                             "+SYSMON:TASK,\"at\",3,1024\r\n", mock_at_output);
+}
+
+static void test_sysmon_periodic(void)
+{
+    test_sysmon_reset();
+
+    const char *const start[] = {"2"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_sysmon, 1, start));
+    TaskHandle_t task = mock_task_find("sysmon");
+    TEST_ASSERT(task != NULL);
+    mock_current_task = task;
+
+    // the notification of the command restarts the period, then it reports every interval
+    TickType_t period_start = 0;
+    mock_tick = 10;
+    TEST_ASSERT(!at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+    TEST_ASSERT_EQUAL(10, period_start);
+    TEST_ASSERT(at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+    TEST_ASSERT_EQUAL(2010, mock_tick);
+
+    // a report taking some time does not delay the next one
+    mock_tick += 300;
+    TEST_ASSERT(at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+    TEST_ASSERT_EQUAL(4010, mock_tick);
+}
+
+static void test_sysmon_stop_and_restart(void)
+{
+    test_sysmon_reset();
+
+    const char *const start[] = {"1"};
+    const char *const stop[] = {"0"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_sysmon, 1, start));
+    TaskHandle_t task = mock_task_find("sysmon");
+    mock_current_task = task;
+    TickType_t period_start = 0;
+    TEST_ASSERT(!at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+
+    // stopped, the task blocks until it is notified again and does not report
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_sysmon, 1, stop));
+    TEST_ASSERT(!at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+    mock_notify_tick = mock_tick + 5000;
+    TEST_ASSERT(!at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+
+    // restarted at once, the same task carries on with the new interval
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_sysmon, 1, stop));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_sysmon, 1, start));
+    TEST_ASSERT_EQUAL(1, mock_task_num);
+    TEST_ASSERT(!at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+    TickType_t restart = mock_tick;
+    TEST_ASSERT(at_sysmon_wait_period(&period_start, s_sysmon_interval * 1000));
+    TEST_ASSERT_EQUAL(restart + 1000, mock_tick);
+}
+
+static void test_sysmon_invalid_interval(void)
+{
+    test_sysmon_reset();
+
+    const char *const too_long[] = {"3601"};
+    const char *const negative[] = {"-1"};
+    const char *const too_many[] = {"1", "1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_sysmon, 1, too_long));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_sysmon, 1, negative));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_sysmon, 2, too_many));
+
+    // stopping the report before it is started does not create the task
+    const char *const stop[] = {"0"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_sysmon, 1, stop));
+    TEST_ASSERT_EQUAL(0, mock_task_num);
+
+    mock_task_create_fail = true;
+    const char *const start[] = {"1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_sysmon, 1, start));
+}
+
+// the tasks run during every sampling window: "busy" for a quarter of it, "idle" for the rest
+static void test_syscpu_delay_hook(TickType_t ticks)
+{
+    mock_task_status[0].ulRunTimeCounter += ticks * 1000 / 4;
+    mock_task_status[1].ulRunTimeCounter += ticks * 1000 - ticks * 1000 / 4;
+}
+
+static void test_syscpu_tasks_init(void)
+{
+    static struct mock_task busy, idle;
+    mock_task_status[0] = (TaskStatus_t) {
+        .xHandle = &busy, .pcTaskName = "busy", .xTaskNumber = 1, .ulRunTimeCounter = 5000,
+    };
+    mock_task_status[1] = (TaskStatus_t) {
+        .xHandle = &idle, .pcTaskName = "idle", .xTaskNumber = 2, .ulRunTimeCounter = 7000,
+    };
+    mock_task_status_num = 2;
+    mock_delay_hook = test_syscpu_delay_hook;
+}
+
+static void test_syscpu_task_delta(void)
+{
+    static struct mock_task a, b;
+    const TaskStatus_t prev[] = {
+        {.xHandle = &a, .xTaskNumber = 1, .ulRunTimeCounter = 1000},
+        {.xHandle = &b, .xTaskNumber = 2, .ulRunTimeCounter = 0xfffffff0},
+    };
+
+    // the same task
+    TaskStatus_t cur = {.xHandle = &a, .xTaskNumber = 1, .ulRunTimeCounter = 1500};
+    TEST_ASSERT_EQUAL(500, at_syscpu_task_delta(prev, 2, &cur));
+
+    // the run time counter wraps around during the window
+    cur = (TaskStatus_t) {.xHandle = &b, .xTaskNumber = 2, .ulRunTimeCounter = 0x10};
+    TEST_ASSERT_EQUAL(0x20, at_syscpu_task_delta(prev, 2, &cur));
+
+    // the handle of a deleted task is reused by a new task, which counts from zero
+    cur = (TaskStatus_t) {.xHandle = &a, .xTaskNumber = 3, .ulRunTimeCounter = 300};
+    TEST_ASSERT_EQUAL(300, at_syscpu_task_delta(prev, 2, &cur));
+
+    // a task created during the window
+    static struct mock_task c;
+    cur = (TaskStatus_t) {.xHandle = &c, .xTaskNumber = 4, .ulRunTimeCounter = 200};
+    TEST_ASSERT_EQUAL(200, at_syscpu_task_delta(prev, 2, &cur));
+}
+
+static void test_syscpu_report(void)
+{
+    test_sysmon_reset();
+    test_syscpu_tasks_init();
+
+    TEST_ASSERT(at_syscpu_report("+SYSCPU", 1000, esp_at_port_active_write_data));
+    TEST_ASSERT_EQUAL(1001, mock_tick);
+    TEST_ASSERT_EQUAL_STRING("+SYSCPU:\"busy\",25.00,250000\r\n"
+                             "+SYSCPU:\"idle\",75.00,750000\r\n", mock_at_output);
+}
+
+static void test_syscpu_oneshot_on_task(void)
+{
+    test_sysmon_reset();
+    test_syscpu_tasks_init();
+
+    // the command returns at once, and the task reports after the window
+    const char *const oneshot[] = {"500"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 1, oneshot));
+    TEST_ASSERT_EQUAL(1, mock_tick);
+    TEST_ASSERT_EQUAL(0, mock_at_output_len);
+    TaskHandle_t task = mock_task_find("syscpu");
+    TEST_ASSERT(task != NULL);
+    mock_current_task = task;
+
+    TickType_t period_start = mock_tick;
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(501, mock_tick);
+    TEST_ASSERT_EQUAL_STRING("+SYSCPU:\"busy\",25.00,125000\r\n"
+                             "+SYSCPU:\"idle\",75.00,375000\r\n", mock_at_output);
+
+    // the one-shot window does not change the periodic settings
+    mock_at_reset();
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_syscpu((uint8_t *)"+SYSCPU"));
+    TEST_ASSERT_EQUAL_STRING("+SYSCPU:1000,0\r\n", mock_at_output);
+
+    // only one one-shot sampling is pending at a time
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 1, oneshot));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_syscpu, 1, oneshot));
+    TEST_ASSERT_EQUAL(1, mock_task_num);
+}
+
+static void test_syscpu_periodic_with_oneshot(void)
+{
+    test_sysmon_reset();
+    test_syscpu_tasks_init();
+
+    const char *const periodic[] = {"200", "1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 2, periodic));
+    mock_current_task = mock_task_find("syscpu");
+
+    // the notification restarts the period, then the sampling starts once a second
+    TickType_t period_start = 0;
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(0, mock_at_output_len);
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(1201, mock_tick);
+    TEST_ASSERT(strstr(mock_at_output, "+SYSCPU:\"busy\",25.00,50000\r\n") != NULL);
+
+    // a one-shot window longer than the interval is sampled on its own
+    const char *const oneshot[] = {"5000"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 1, oneshot));
+    mock_at_reset();
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(6201, mock_tick);
+    TEST_ASSERT(strstr(mock_at_output, "+SYSCPU:\"busy\",25.00,1250000\r\n") != NULL);
+    TEST_ASSERT_EQUAL(200, s_syscpu_window_ms);
+
+    // the periodic sampling goes on with its own window from the notification
+    mock_at_reset();
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(0, mock_at_output_len);
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(7401, mock_tick);
+    TEST_ASSERT(strstr(mock_at_output, "+SYSCPU:\"busy\",25.00,50000\r\n") != NULL);
+}
+
+static void test_syscpu_stop_and_restart(void)
+{
+    test_sysmon_reset();
+    test_syscpu_tasks_init();
+
+    const char *const start[] = {"200", "1"};
+    const char *const stop[] = {"200", "0"};
+    const char *const restart[] = {"300", "2"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 2, start));
+    mock_current_task = mock_task_find("syscpu");
+    TickType_t period_start = 0;
+    at_syscpu_poll(&period_start);
+
+    // stopped and restarted before the task runs again, the same task samples with the new settings
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 2, stop));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 2, restart));
+    TEST_ASSERT_EQUAL(1, mock_task_num);
+    at_syscpu_poll(&period_start);
+    TickType_t restart_tick = mock_tick;
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(restart_tick + 2000 + 300, mock_tick);
+    TEST_ASSERT(strstr(mock_at_output, "+SYSCPU:\"busy\",25.00,75000\r\n") != NULL);
+
+    // stopped, the task waits for the next command without sampling
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, test_setup_cmd(at_setup_cmd_syscpu, 2, stop));
+    at_syscpu_poll(&period_start);
+    mock_at_reset();
+    mock_notify_tick = mock_tick + 10000;
+    at_syscpu_poll(&period_start);
+    TEST_ASSERT_EQUAL(0, mock_at_output_len);
+}
+
+static void test_syscpu_invalid(void)
+{
+    test_sysmon_reset();
+
+    const char *const short_window[] = {"99"};
+    const char *const long_window[] = {"10001"};
+    const char *const window_over_interval[] = {"1000", "1"};
+    const char *const too_many[] = {"1000", "2", "1"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_syscpu, 1, short_window));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_syscpu, 1, long_window));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_syscpu, 2, window_over_interval));
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_syscpu, 3, too_many));
+    TEST_ASSERT_EQUAL(0, mock_task_num);
+
+    mock_task_create_fail = true;
+    const char *const oneshot[] = {"1000"};
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_ERROR, test_setup_cmd(at_setup_cmd_syscpu, 1, oneshot));
+    TEST_ASSERT_EQUAL(0, s_syscpu_oneshot_window_ms);
+}
+
+static void test_alloc_fail_reset(void)
+{
+    test_sysmon_reset();
+    // the RTC memory after a power-on reset
+    memset(&s_alloc_fail_ring, 0xa5, sizeof(s_alloc_fail_ring));
+    at_alloc_fail_ring_init();
+}
+
+static void test_alloc_fail_ring_wrap(void)
+{
+    test_alloc_fail_reset();
+    TaskHandle_t task = NULL;
+    xTaskCreate(NULL, "at_process_task", 4096, NULL, 2, &task);
+    mock_current_task = task;
+
+    for (int i = 1; i <= AT_ALLOC_FAIL_RECORD_NUM + 4; i++) {
+        mock_tick = i * 10;
+        at_alloc_failed_record(i * 100, MALLOC_CAP_INTERNAL);
+    }
+    TEST_ASSERT_EQUAL(0, s_alloc_fail_lock.nesting);
+    TEST_ASSERT_EQUAL(AT_ALLOC_FAIL_RECORD_NUM, s_alloc_fail_ring.count);
+
+    // the oldest 4 records are overwritten, the rest is read out from the oldest one
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_sysallocfail((uint8_t *)"+SYSALLOCFAIL"));
+    TEST_ASSERT(strncmp(mock_at_output, "+SYSALLOCFAIL:0,500,0x800,\"at_process_t\",50,60000\r\n",
+                        strlen("+SYSALLOCFAIL:0,500,0x800,\"at_process_t\",50,60000\r\n")) == 0);
+    TEST_ASSERT(strstr(mock_at_output, "+SYSALLOCFAIL:0,2000,0x800,\"at_process_t\",200,60000\r\n") != NULL);
+    int lines = 0;
+    for (const char *p = mock_at_output; (p = strstr(p, "+SYSALLOCFAIL:")) != NULL; p++) {
+        lines++;
+    }
+    TEST_ASSERT_EQUAL(AT_ALLOC_FAIL_RECORD_NUM, lines);
+
+    // read and clear
+    mock_at_reset();
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_sysallocfail((uint8_t *)"+SYSALLOCFAIL"));
+    TEST_ASSERT_EQUAL(0, mock_at_output_len);
+
+    // the ring goes on after it is cleared
+    at_alloc_failed_record(64, MALLOC_CAP_DMA);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_sysallocfail((uint8_t *)"+SYSALLOCFAIL"));
+    TEST_ASSERT_EQUAL_STRING("+SYSALLOCFAIL:0,64,0x8,\"at_process_t\",200,60000\r\n", mock_at_output);
+    TEST_ASSERT_EQUAL(0, s_alloc_fail_lock.nesting);
+}
+
+static void test_alloc_fail_ring_survival(void)
+{
+    test_alloc_fail_reset();
+    at_alloc_failed_record(100, MALLOC_CAP_INTERNAL);
+    at_alloc_failed_record(200, MALLOC_CAP_DMA);
+
+    // a soft reset keeps the ring, and the records tell in which boot they happened
+    at_alloc_fail_ring_init();
+    mock_tick = 7;
+    at_alloc_failed_record(300, MALLOC_CAP_INTERNAL);
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_sysallocfail((uint8_t *)"+SYSALLOCFAIL"));
+    TEST_ASSERT_EQUAL_STRING("+SYSALLOCFAIL:1,100,0x800,\"main\",1,60000\r\n"
+                             "+SYSALLOCFAIL:1,200,0x8,\"main\",1,60000\r\n"
+                             "+SYSALLOCFAIL:0,300,0x800,\"main\",7,60000\r\n", mock_at_output);
+
+    // the ring is reset if it is corrupted
+    at_alloc_failed_record(100, MALLOC_CAP_INTERNAL);
+    s_alloc_fail_ring.head = AT_ALLOC_FAIL_RECORD_NUM;
+    at_alloc_fail_ring_init();
+    TEST_ASSERT_EQUAL(0, s_alloc_fail_ring.count);
+    TEST_ASSERT_EQUAL(1, s_alloc_fail_ring.boot_seq);
+
+    at_alloc_failed_record(100, MALLOC_CAP_INTERNAL);
+    s_alloc_fail_ring.magic = 0;
+    at_alloc_fail_ring_init();
+    TEST_ASSERT_EQUAL(0, s_alloc_fail_ring.count);
+}
+
+static void test_alloc_fail_cache_disabled(void)
+{
+    test_alloc_fail_reset();
+
+    // the functions in flash are not called while the flash cache is disabled
+    mock_flash_cache_disabled = true;
+    at_alloc_failed_record(128, MALLOC_CAP_DMA);
+    mock_flash_cache_disabled = false;
+    TEST_ASSERT_EQUAL(ESP_AT_RESULT_CODE_OK, at_query_cmd_sysallocfail((uint8_t *)"+SYSALLOCFAIL"));
+    TEST_ASSERT_EQUAL_STRING("+SYSALLOCFAIL:0,128,0x8,\"\",1,0\r\n", mock_at_output);
+}
+
+int main(void)
+{
+    RUN_TEST(test_sysmon_report_format);
+    RUN_TEST(test_sysmon_periodic);
+    RUN_TEST(test_sysmon_stop_and_restart);
+    RUN_TEST(test_sysmon_invalid_interval);
+    RUN_TEST(test_syscpu_task_delta);
+    RUN_TEST(test_syscpu_report);
+    RUN_TEST(test_syscpu_oneshot_on_task);
+    RUN_TEST(test_syscpu_periodic_with_oneshot);
+    RUN_TEST(test_syscpu_stop_and_restart);
+    RUN_TEST(test_syscpu_invalid);
+    RUN_TEST(test_alloc_fail_ring_wrap);
+    RUN_TEST(test_alloc_fail_ring_survival);
+    RUN_TEST(test_alloc_fail_cache_disabled);
+    return TEST_RESULT();
+}
@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_host.h"
+
+#define CONFIG_APP_PROJECT_VER              "v4.1.0.0-dev"
+#define CONFIG_AT_DEBUG                     1
+#define CONFIG_ESP_TASK_WDT_TIMEOUT_S       5
+#include "at_init.c"
+#include "mock.h"
+#include "mock_at.h"
+
+#define TEST_BIN_VERSION(name)  "Bin version:" CONFIG_APP_PROJECT_VER "(" name ")\r\n"
+
+static const char *s_module_name;
+static char s_version[AT_VERSION_BUFFER_SIZE];
+static int s_module_init_count;
+
+void at_interface_init(void)
+{
+}
+
+void at_interface_start(void)
+{
+}
+
+void esp_at_module_init(const uint8_t *custom_version)
+{
+    // the core copies the version, as the buffer is gone after the init
+    snprintf(s_version, sizeof(s_version), "%s", (const char *)custom_version);
+    s_module_init_count++;
+}
+
+void esp_at_cmd_set_register(void)
+{
+}
+
+void esp_at_set_module_id(uint32_t id)
+{
+}
+
+void esp_at_set_module_id_by_str(const char *buffer)
+{
+}
+
+const char *esp_at_get_current_module_name(void)
+{
+    return s_module_name;
+}
+
+esp_err_t esp_at_nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return nvs_get_str(handle, key, out_value, length);
+}
+
+int32_t esp_at_get_core_version(char *buffer, uint32_t size)
+{
+    return snprintf(buffer, size, "AT version:4.1.0.0-dev(host)\r\n");
+}
+
+const char *esp_get_idf_version(void)
+{
+    return "v5.4";
+}
+
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t *config)
+{
+    return ESP_OK;
+}
+
+static void test_version_module_init(void)
+{
+    s_module_name = "MINI-1";
+    s_module_init_count = 0;
+    at_module_init();
+
+    // the compile-time line comes first, followed by the bin version of the current module
+    TEST_ASSERT_EQUAL(1, s_module_init_count);
+    TEST_ASSERT_EQUAL_STRING("compile time(host):" __DATE__ " " __TIME__ "\r\n" TEST_BIN_VERSION("MINI-1"), s_version);
+
+    // the core version logged in the debug builds does not leak into it
+    s_module_name = "ESP32C3-SPI";
+    at_module_init();
+    TEST_ASSERT_EQUAL_STRING("compile time(host):" __DATE__ " " __TIME__ "\r\n" TEST_BIN_VERSION("ESP32C3-SPI"), s_version);
+}
+
+static void test_version_build_truncated(void)
+{
+    char buffer[AT_VERSION_BUFFER_SIZE];
+    char name[AT_MFG_MODULE_NAME_MAX_LEN + 1];
+
+    // the longest module name still fits
+    memset(name, 'M', AT_MFG_MODULE_NAME_MAX_LEN);
+    name[AT_MFG_MODULE_NAME_MAX_LEN] = '\0';
+    s_module_name = name;
+    at_version_str_build(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(strlen(s_at_compile_time_str) + strlen(TEST_BIN_VERSION("")) + AT_MFG_MODULE_NAME_MAX_LEN, strlen(buffer));
+    TEST_ASSERT_EQUAL_STRING("M)\r\n", buffer + strlen(buffer) - 4);
+
+    // a short buffer is cut, but always terminated
+    memset(buffer, 0x5A, sizeof(buffer));
+    at_version_str_build(buffer, 8);
+    TEST_ASSERT_EQUAL_STRING("compile", buffer);
+    TEST_ASSERT_EQUAL(0x5A, (uint8_t)buffer[8]);
+
+    at_version_str_build(buffer, sizeof(s_at_compile_time_str) + 5);
+    TEST_ASSERT_EQUAL_MEMORY(s_at_compile_time_str, buffer, sizeof(s_at_compile_time_str) - 1);
+    TEST_ASSERT_EQUAL_STRING("Bin v", buffer + sizeof(s_at_compile_time_str) - 1);
+}
+
+int main(void)
+{
+    RUN_TEST(test_version_module_init);
+    RUN_TEST(test_version_build_truncated);
+    return TEST_RESULT();
+}
@@ -15,6 +15,7 @@
 #include "freertos/event_groups.h"
 
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "nvs.h"
@@ -71,14 +72,24 @@
 #define RAINMAKER_NODE_ATTR_KV_GROUP_MAX            (RAINMAKER_NODE_ATTR_MAX_SETS / 2 + 1)  // +1 for loop exit
 #define RAINMAKER_PARAM_STR_LIST_MAX_SETS           (8)
 #define RAINMAKER_PARAM_STR_LIST_ARAAY_MAX          (RAINMAKER_PARAM_STR_LIST_MAX_SETS + 1) // +1 for NULL termination
+#define RAINMAKER_PARAMS_BATCH_MAX_SETS             (ESP_AT_PARA_NUM_MAX / 3)   // groups of unique_name, param_name and param_value
+
+#define RAINMAKER_NAME_INDEX_BUCKETS                (32)    // must be power of 2
+#define RAINMAKER_REPORT_DEBOUNCE_MS_MAX            (60 * 1000)
 
 #define RAINMAKER_PASSTHROUGH_BUFFER_LEN            (2048)
 #define RAINMAKER_PASSTHROUGH_MAX_PARAM_NUMS        (1)
+#define RAINMAKER_PASSTHROUGH_WINDOW_MS_DEF         (20)
+#define RAINMAKER_PASSTHROUGH_WINDOW_MS_MAX         (10 * 1000)
+#define RAINMAKER_PASSTHROUGH_SIZE_MIN              (16)
+#define RAINMAKER_PASSTHROUGH_ESCAPE_LEN            (3)     // "+++"
+#define RAINMAKER_PASSTHROUGH_ESCAPE_GUARD_MS       (20)    // no data is allowed after "+++" within this time
 
 #define RAINMAKER_NODE_NAME                         ("ESP RainMaker AT Node")
 #define RAINMAKER_NODE_TYPE                         ("AT Node")
 
 #define DATA_FORMAT                                 ("+RMRECV")
+#define RAINMAKER_RECV_FORMAT_BUFFER_LEN            (128)   // longer messages fall back to the heap
 #define SWAP_16(x)                                  ((uint16_t)((((x)&0xff00) >> 8) | (((x)&0x00ff) << 8)))
 #define BLE_NAME_LEN_MAX                            (12)
 
@@ -156,6 +167,20 @@ typedef struct {
     uint8_t *value;
 } at_rm_kv_data_t;
 
+typedef struct at_rm_name_index {
+    uint32_t hash;
+    esp_rmaker_device_t *device;
+    esp_rmaker_param_t *param;      // NULL for the device itself
+    struct at_rm_name_index *next;
+} at_rm_name_index_t;
+
+typedef struct {
+    uint32_t events;
+    uint32_t fallbacks;
+    uint32_t last_events;
+    int64_t last_time_us;
+} at_rm_recv_stats_t;
+
 typedef struct {
     uint16_t customer_id;
     char ble_name[BLE_NAME_LEN_MAX + 1]; // +1 for NULL termination
@@ -167,6 +192,7 @@ typedef struct {
 extern esp_rmaker_val_type_t esp_rmaker_param_get_data_type(const esp_rmaker_param_t *param);
 extern esp_err_t esp_rmaker_reset_user_node_mapping(void);
 extern char *esp_rmaker_ota_status_to_string(ota_status_t status);
+extern esp_err_t esp_rmaker_param_report_updated(void);
 
 static const char *TAG = "rainmaker";
 
@@ -178,6 +204,12 @@ static EventGroupHandle_t s_rm_event_group;
 static at_rainmaker_mode_t s_mode = AT_RM_NORMAL;
 static uint32_t s_rm_param_nums = 0;
 static esp_rmaker_node_t *sp_node = NULL;
+static at_rm_name_index_t **sp_name_index = NULL;
+static uint32_t s_report_debounce_ms = 0;
+static TimerHandle_t s_report_timer;
+static at_rm_recv_stats_t s_recv_stats;
+static uint32_t s_passthrough_window_ms = RAINMAKER_PASSTHROUGH_WINDOW_MS_DEF;
+static uint32_t s_passthrough_size = RAINMAKER_PASSTHROUGH_BUFFER_LEN;
 
 static at_rm_profile_t s_profile = {
     .customer_id = 0x0001,
@@ -574,6 +606,30 @@ esp_err_t rmaker_ota_handle(esp_rmaker_ota_handle_t ota_handle, esp_rmaker_ota_d
 #endif /* CONFIG_BOOTLOADER_COMPRESSED_ENABLED */
 }
 
+static int rmaker_format_recv(char *buf, size_t size, bool passthrough, const char *src_name,
+                              const char *device_name, const char *param_name, const esp_rmaker_param_val_t *val)
+{
+    if (passthrough) {
+        if (val->type == RMAKER_VAL_TYPE_BOOLEAN) {
+            return snprintf(buf, size, "%d", val->val.b);
+        } else if (val->type == RMAKER_VAL_TYPE_INTEGER) {
+            return snprintf(buf, size, "%d", val->val.i);
+        } else {
+            return snprintf(buf, size, "%f", val->val.f);
+        }
+    }
+
+    if (val->type == RMAKER_VAL_TYPE_BOOLEAN) {
+        return snprintf(buf, size, "%s:%s,%s,%s:%d\r\n", DATA_FORMAT, src_name, device_name, param_name, val->val.b);
+    } else if (val->type == RMAKER_VAL_TYPE_INTEGER) {
+        return snprintf(buf, size, "%s:%s,%s,%s:%d\r\n", DATA_FORMAT, src_name, device_name, param_name, val->val.i);
+    } else if (val->type == RMAKER_VAL_TYPE_FLOAT) {
+        return snprintf(buf, size, "%s:%s,%s,%s:%f\r\n", DATA_FORMAT, src_name, device_name, param_name, val->val.f);
+    } else {
+        return snprintf(buf, size, "%s:%s,%s,%s:%s\r\n", DATA_FORMAT, src_name, device_name, param_name, val->val.s);
+    }
+}
+
 static esp_err_t write_cb(const esp_rmaker_device_t *device, const esp_rmaker_param_t *param,
                           const esp_rmaker_param_val_t val, void *priv_data, esp_rmaker_write_ctx_t *ctx)
 {
@@ -583,34 +639,30 @@ static esp_err_t write_cb(const esp_rmaker_device_t *device, const esp_rmaker_pa
     const char *device_name = esp_rmaker_device_get_name(device);
     const char *param_name = esp_rmaker_param_get_name(param);
     const char *src_name = esp_rmaker_device_cb_src_to_str(ctx->src);
+    bool passthrough = (xEventGroupGetBits(s_rm_event_group) & RM_IN_PASSTHROUGH_MODE);
 
-    // passthrough mode
-    if ((xEventGroupGetBits(s_rm_event_group) & RM_IN_PASSTHROUGH_MODE)) {
-        char *buf = NULL;
-        if (val.type == RMAKER_VAL_TYPE_BOOLEAN) {
-            asprintf(&buf, "%d", val.val.b);
-        } else if (val.type == RMAKER_VAL_TYPE_INTEGER) {
-            asprintf(&buf, "%d", val.val.i);
-        } else if (val.type == RMAKER_VAL_TYPE_FLOAT) {
-            asprintf(&buf, "%f", val.val.f);
-        } else {
-            asprintf(&buf, "%s", val.val.s);
+    s_recv_stats.events++;
+
+    if (passthrough && (val.type != RMAKER_VAL_TYPE_BOOLEAN) && (val.type != RMAKER_VAL_TYPE_INTEGER) && (val.type != RMAKER_VAL_TYPE_FLOAT)) {
+        // passthrough mode, the string is sent as it is
+        if (val.val.s) {
+            esp_at_port_write_data((uint8_t *)val.val.s, strlen(val.val.s));
         }
-        esp_at_port_write_data((uint8_t *)buf, strlen((char *)buf));
-        free(buf);
     } else {
-        char *buf = NULL;
-        if (val.type == RMAKER_VAL_TYPE_BOOLEAN) {
-            asprintf(&buf, "%s:%s,%s,%s:%d\r\n", DATA_FORMAT, src_name, device_name, param_name, val.val.b);
-        } else if (val.type == RMAKER_VAL_TYPE_INTEGER) {
-            asprintf(&buf, "%s:%s,%s,%s:%d\r\n", DATA_FORMAT, src_name, device_name, param_name, val.val.i);
-        } else if (val.type == RMAKER_VAL_TYPE_FLOAT) {
-            asprintf(&buf, "%s:%s,%s,%s:%f\r\n", DATA_FORMAT, src_name, device_name, param_name, val.val.f);
+        // format on the stack of the calling task, only long strings need the heap
+        char buf[RAINMAKER_RECV_FORMAT_BUFFER_LEN];
+        int len = rmaker_format_recv(buf, sizeof(buf), passthrough, src_name, device_name, param_name, &val);
+        if (len < sizeof(buf)) {
+            esp_at_port_write_data((uint8_t *)buf, len);
         } else {
-            asprintf(&buf, "%s:%s,%s,%s:%s\r\n", DATA_FORMAT, src_name, device_name, param_name, val.val.s);
+            s_recv_stats.fallbacks++;
+            char *long_buf = (char *)malloc(len + 1);
+            if (long_buf) {
+                rmaker_format_recv(long_buf, len + 1, passthrough, src_name, device_name, param_name, &val);
+                esp_at_port_write_data((uint8_t *)long_buf, len);
+                free(long_buf);
+            }
         }
-        esp_at_port_write_data((uint8_t *)buf, strlen((char *)buf));
-        free(buf);
     }
 
     /* auto response to cloud */
@@ -837,6 +889,137 @@ static void rmaker_structure_data(esp_rmaker_val_type_t type, uint8_t *inbuf, es
     memcpy(out_val, &val, sizeof(esp_rmaker_param_val_t));
 }
 
+static uint32_t rmaker_name_hash(const char *device_name, const char *param_name)
+{
+    // FNV-1a over "<device_name>\0<param_name>"
+    uint32_t hash = 2166136261u;
+    for (const char *p = device_name; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    if (param_name) {
+        hash = (hash ^ 0) * 16777619u;
+        for (const char *p = param_name; *p; p++) {
+            hash = (hash ^ (uint8_t)*p) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+static void rmaker_name_index_add(esp_rmaker_device_t *device, esp_rmaker_param_t *param)
+{
+    if (!sp_name_index || !device) {
+        return;
+    }
+
+    at_rm_name_index_t *entry = (at_rm_name_index_t *)calloc(1, sizeof(at_rm_name_index_t));
+    if (!entry) {
+        // the lookup falls back to the rmaker API if the entry is missing
+        return;
+    }
+    entry->hash = rmaker_name_hash(esp_rmaker_device_get_name(device), param ? esp_rmaker_param_get_name(param) : NULL);
+    entry->device = device;
+    entry->param = param;
+
+    uint32_t bucket = entry->hash & (RAINMAKER_NAME_INDEX_BUCKETS - 1);
+    entry->next = sp_name_index[bucket];
+    sp_name_index[bucket] = entry;
+}
+
+static void rmaker_name_index_remove_device(esp_rmaker_device_t *device)
+{
+    if (!sp_name_index) {
+        return;
+    }
+
+    for (int i = 0; i < RAINMAKER_NAME_INDEX_BUCKETS; i++) {
+        at_rm_name_index_t **pp = &sp_name_index[i];
+        while (*pp) {
+            if ((*pp)->device == device) {
+                at_rm_name_index_t *entry = *pp;
+                *pp = entry->next;
+                free(entry);
+            } else {
+                pp = &(*pp)->next;
+            }
+        }
+    }
+}
+
+static at_rm_name_index_t *rmaker_name_index_find(const char *device_name, const char *param_name)
+{
+    if (!sp_name_index) {
+        return NULL;
+    }
+
+    uint32_t hash = rmaker_name_hash(device_name, param_name);
+    for (at_rm_name_index_t *entry = sp_name_index[hash & (RAINMAKER_NAME_INDEX_BUCKETS - 1)]; entry; entry = entry->next) {
+        if (entry->hash != hash || (param_name == NULL) != (entry->param == NULL)) {
+            continue;
+        }
+        if (strcmp(esp_rmaker_device_get_name(entry->device), device_name) != 0) {
+            continue;
+        }
+        if (param_name && strcmp(esp_rmaker_param_get_name(entry->param), param_name) != 0) {
+            continue;
+        }
+        return entry;
+    }
+
+    return NULL;
+}
+
+static esp_rmaker_device_t *rmaker_get_device(const char *device_name)
+{
+    at_rm_name_index_t *entry = rmaker_name_index_find(device_name, NULL);
+    if (entry) {
+        return entry->device;
+    }
+
+    return esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), device_name);
+}
+
+static esp_rmaker_param_t *rmaker_get_param(const char *device_name, const char *param_name)
+{
+    at_rm_name_index_t *entry = rmaker_name_index_find(device_name, param_name);
+    if (entry) {
+        return entry->param;
+    }
+
+    esp_rmaker_device_t *device = rmaker_get_device(device_name);
+    if (!device) {
+        return NULL;
+    }
+    return esp_rmaker_device_get_param_by_name(device, param_name);
+}
+
+static void rmaker_report_work_cb(void *priv_data)
+{
+    esp_rmaker_param_report_updated();
+}
+
+static void rmaker_report_timer_cb(TimerHandle_t tmr)
+{
+    // report in the rmaker work queue, the timer task stack is too small to publish
+    esp_rmaker_work_queue_add_task(rmaker_report_work_cb, NULL);
+}
+
+static esp_err_t rmaker_report_updated_params(void)
+{
+    // the reports are always published from the rmaker work queue, like the other rmaker reports
+    if (s_report_debounce_ms == 0 || !s_report_timer) {
+        return esp_rmaker_work_queue_add_task(rmaker_report_work_cb, NULL);
+    }
+
+    // all the params updated within the debounce window are reported in one publish
+    if (!xTimerIsTimerActive(s_report_timer)) {
+        if (xTimerChangePeriod(s_report_timer, pdMS_TO_TICKS(s_report_debounce_ms), portMAX_DELAY) != pdPASS) {
+            return ESP_FAIL;
+        }
+    }
+
+    return ESP_OK;
+}
+
 static esp_err_t rmaker_ota_report_status(const char *ota_job, ota_status_t status, char *additional_info)
 {
     char *publish_payload = NULL;
@@ -953,6 +1136,14 @@ static uint8_t at_exe_cmd_rmnodeinit(uint8_t *cmd_name)
     esp_rmaker_timezone_service_enable();
     esp_rmaker_schedule_enable();
 
+    // name index for the devices and params added later
+    if (!sp_name_index) {
+        sp_name_index = (at_rm_name_index_t **)calloc(RAINMAKER_NAME_INDEX_BUCKETS, sizeof(at_rm_name_index_t *));
+    }
+    if (!s_report_timer) {
+        s_report_timer = xTimerCreate("rm report timer", 1, false, NULL, rmaker_report_timer_cb);
+    }
+
     xEventGroupSetBits(s_rm_event_group, RM_NODE_INIT_DONE_EVENT);
 
     // set fw_version field in "info" in node configuration
@@ -1086,8 +1277,11 @@ static uint8_t at_setup_cmd_rmdev(uint8_t para_num)
         }
         esp_rmaker_device_add_cb(device, write_cb, NULL);
         // Name is a required parameter
-        esp_rmaker_device_add_param(device, esp_rmaker_name_param_create(ESP_RMAKER_DEF_NAME_PARAM, (const char *)device_name));
+        esp_rmaker_param_t *name_param = esp_rmaker_name_param_create(ESP_RMAKER_DEF_NAME_PARAM, (const char *)device_name);
+        esp_rmaker_device_add_param(device, name_param);
         esp_rmaker_node_add_device(esp_rmaker_get_node(), device);
+        rmaker_name_index_add(device, NULL);
+        rmaker_name_index_add(device, name_param);
 
         //Update device code
         s_profile.device_type_code = rmaker_get_device_code(device_type);
@@ -1102,12 +1296,13 @@ static uint8_t at_setup_cmd_rmdev(uint8_t para_num)
         // parameters are ready
         CHECK_PARAMS_NUM(cnt, para_num);
 
-        esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
+        esp_rmaker_device_t *device = rmaker_get_device((const char *)unique_name);
         if (!device) {
             //TODO: error code, device not found
             return ESP_AT_RESULT_CODE_ERROR;
         }
 
+        rmaker_name_index_remove_device(device);
         esp_rmaker_node_remove_device(esp_rmaker_get_node(), device);
         esp_rmaker_device_delete(device);
 
@@ -1180,7 +1375,7 @@ static uint8_t at_setup_cmd_rmparam(uint8_t para_num)
     CHECK_PARAMS_NUM(cnt, para_num);
 
     // device check
-    esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
+    esp_rmaker_device_t *device = rmaker_get_device((const char *)unique_name);
     if (!device) {
         //TODO: error code, device not found
         return ESP_AT_RESULT_CODE_ERROR;
@@ -1205,6 +1400,7 @@ static uint8_t at_setup_cmd_rmparam(uint8_t para_num)
         //TODO: error code, device not found
         return ESP_AT_RESULT_CODE_ERROR;
     }
+    rmaker_name_index_add(device, param);
 
     /* Record the number of parameters, which will be checked in the transmission mode */
     s_rm_param_nums++;
@@ -1267,14 +1463,9 @@ static uint8_t at_setup_cmd_rmparambounds(uint8_t para_num)
     // parameters are ready
     CHECK_PARAMS_NUM(cnt, para_num);
 
-    esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
-    if (!device) {
-        //TODO: error code, device not found
-        return ESP_AT_RESULT_CODE_ERROR;
-    }
-    esp_rmaker_param_t *param = esp_rmaker_device_get_param_by_name(device, (const char *)param_name);
+    esp_rmaker_param_t *param = rmaker_get_param((const char *)unique_name, (const char *)param_name);
     if (!param) {
-        //TODO: error code, param not found
+        //TODO: error code, device or param not found
         return ESP_AT_RESULT_CODE_ERROR;
     }
     esp_rmaker_val_type_t type = esp_rmaker_param_get_data_type(param);
@@ -1347,14 +1538,9 @@ static uint8_t at_setup_cmd_rmparamstrlist(uint8_t para_num)
     // parameters are ready
     CHECK_PARAMS_NUM(cnt, para_num);
 
-    esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
-    if (!device) {
-        //TODO: error code, device not found
-        return ESP_AT_RESULT_CODE_ERROR;
-    }
-    esp_rmaker_param_t *param = esp_rmaker_device_get_param_by_name(device, (const char *)param_name);
+    esp_rmaker_param_t *param = rmaker_get_param((const char *)unique_name, (const char *)param_name);
     if (!param) {
-        //TODO: error code, param not found
+        //TODO: error code, device or param not found
         return ESP_AT_RESULT_CODE_ERROR;
     }
     esp_rmaker_val_type_t type = esp_rmaker_param_get_data_type(param);
@@ -1414,14 +1600,9 @@ static uint8_t at_setup_cmd_rmparamcount(uint8_t para_num)
     // parameters are ready
     CHECK_PARAMS_NUM(cnt, para_num);
 
-    esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
-    if (!device) {
-        //TODO: error code, device not found
-        return ESP_AT_RESULT_CODE_ERROR;
-    }
-    esp_rmaker_param_t *param = esp_rmaker_device_get_param_by_name(device, (const char *)param_name);
+    esp_rmaker_param_t *param = rmaker_get_param((const char *)unique_name, (const char *)param_name);
     if (!param) {
-        //TODO: error code, param not found
+        //TODO: error code, device or param not found
         return ESP_AT_RESULT_CODE_ERROR;
     }
     esp_rmaker_val_type_t type = esp_rmaker_param_get_data_type(param);
@@ -1759,19 +1940,13 @@ static uint8_t at_setup_cmd_rmparamupdate(uint8_t para_num)
     // Valid parameters do not include unique_name, so are not counted here
     int para_group_count = (para_num - 1) / 2;
     esp_rmaker_param_val_t val;
-    esp_rmaker_param_t *param = NULL;
-    esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
-    if (!device) {
-        //TODO: error code, device not found
-        return ESP_AT_RESULT_CODE_ERROR;
-    }
+    esp_rmaker_param_t *params[RAINMAKER_PARAMS_KV_GROUP_MAX] = {0};
 
-    //  Query param validity through rmaker API, only continue if all are valid
+    //  Query param validity through the name index, only continue if all are valid
     for (int i = 0; i < para_group_count; i++) {
-        param = NULL;
-        param = esp_rmaker_device_get_param_by_name(device, (const char *)kv_group[i].key);
-        if (!param) {
-            //TODO: error code, param not found
+        params[i] = rmaker_get_param((const char *)unique_name, (const char *)kv_group[i].key);
+        if (!params[i]) {
+            //TODO: error code, device or param not found
             return ESP_AT_RESULT_CODE_ERROR;
         }
     }
@@ -1779,13 +1954,126 @@ static uint8_t at_setup_cmd_rmparamupdate(uint8_t para_num)
     // Write
     for (int i = 0; i < para_group_count; i++) {
         memset(&val, 0, sizeof(esp_rmaker_param_val_t));
-        param = NULL;
-        param = esp_rmaker_device_get_param_by_name(device, (const char *)kv_group[i].key);
-        val.type = esp_rmaker_param_get_data_type(param);
+        val.type = esp_rmaker_param_get_data_type(params[i]);
         rmaker_structure_data(val.type, kv_group[i].value, &val);
-        esp_rmaker_param_update(param, val);
+        esp_rmaker_param_update(params[i], val);
+    }
+
+    // Report all the updated params in one publish
+    if (rmaker_report_updated_params() != ESP_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
     }
-    esp_rmaker_param_update_and_report(param, val);
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_setup_cmd_rmparambatch(uint8_t para_num)
+{
+    int cnt = 0;
+    int set_count = 0;
+    uint8_t *unique_name[RAINMAKER_PARAMS_BATCH_MAX_SETS] = {0};
+    at_rm_kv_data_t kv_group[RAINMAKER_PARAMS_BATCH_MAX_SETS];
+    esp_rmaker_param_t *params[RAINMAKER_PARAMS_BATCH_MAX_SETS] = {0};
+    memset(&kv_group[0], 0, sizeof(at_rm_kv_data_t) * RAINMAKER_PARAMS_BATCH_MAX_SETS);
+
+    if (!(xEventGroupGetBits(s_rm_event_group) & RM_NODE_INIT_DONE_EVENT)) {
+        //TODO: error code, not init
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    if (!(xEventGroupGetBits(s_rm_event_group) & RM_MQTT_CONNECTED_EVENT)) {
+        //TODO: error code, not connect
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    // groups of unique_name, param_name and param_value
+    do {
+        if (esp_at_get_para_as_str(cnt++, &unique_name[set_count]) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (esp_at_get_para_as_str(cnt++, &kv_group[set_count].key) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (esp_at_get_para_as_str(cnt++, &kv_group[set_count].value) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        set_count++;
+    } while (cnt < para_num && set_count < RAINMAKER_PARAMS_BATCH_MAX_SETS);
+
+    // parameters are ready
+    CHECK_PARAMS_NUM(cnt, para_num);
+
+    // only continue if all the params are valid
+    for (int i = 0; i < set_count; i++) {
+        params[i] = rmaker_get_param((const char *)unique_name[i], (const char *)kv_group[i].key);
+        if (!params[i]) {
+            //TODO: error code, device or param not found
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    for (int i = 0; i < set_count; i++) {
+        esp_rmaker_param_val_t val;
+        memset(&val, 0, sizeof(esp_rmaker_param_val_t));
+        val.type = esp_rmaker_param_get_data_type(params[i]);
+        rmaker_structure_data(val.type, kv_group[i].value, &val);
+        esp_rmaker_param_update(params[i], val);
+    }
+
+    if (rmaker_report_updated_params() != ESP_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_query_cmd_rmrecvstat(uint8_t *cmd_name)
+{
+    char buffer[64];
+    int64_t now_us = esp_timer_get_time();
+    uint32_t events = s_recv_stats.events;
+
+    // the rate is the average since the previous query
+    uint32_t rate = 0;
+    if (s_recv_stats.last_time_us && now_us > s_recv_stats.last_time_us) {
+        rate = (uint64_t)(events - s_recv_stats.last_events) * 1000000 / (now_us - s_recv_stats.last_time_us);
+    }
+    s_recv_stats.last_events = events;
+    s_recv_stats.last_time_us = now_us;
+
+    snprintf(buffer, sizeof(buffer), "%s:%u,%u,%u\r\n", cmd_name, events, s_recv_stats.fallbacks, rate);
+    esp_at_port_write_data((uint8_t *)buffer, strlen(buffer));
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_query_cmd_rmreportcfg(uint8_t *cmd_name)
+{
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%s:%u\r\n", cmd_name, s_report_debounce_ms);
+    esp_at_port_write_data((uint8_t *)buffer, strlen(buffer));
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_setup_cmd_rmreportcfg(uint8_t para_num)
+{
+    int cnt = 0;
+    int32_t debounce_ms = 0;
+
+    // debounce_ms
+    if (esp_at_get_para_as_digit(cnt++, &debounce_ms) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    if ((debounce_ms < 0) || (debounce_ms > RAINMAKER_REPORT_DEBOUNCE_MS_MAX)) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    // parameters are ready
+    CHECK_PARAMS_NUM(cnt, para_num);
+
+    s_report_debounce_ms = debounce_ms;
 
     return ESP_AT_RESULT_CODE_OK;
 }
@@ -1811,10 +2099,34 @@ static uint8_t at_setup_cmd_rmmode(uint8_t para_num)
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
+    // coalescing window
+    int32_t window_ms = s_passthrough_window_ms;
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &window_ms) == ESP_AT_PARA_PARSE_RESULT_FAIL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if ((window_ms < 0) || (window_ms > RAINMAKER_PASSTHROUGH_WINDOW_MS_MAX)) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    // coalescing size
+    int32_t size = s_passthrough_size;
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &size) == ESP_AT_PARA_PARSE_RESULT_FAIL) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if ((size < RAINMAKER_PASSTHROUGH_SIZE_MIN) || (size > RAINMAKER_PASSTHROUGH_BUFFER_LEN)) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
     // parameters are ready
     CHECK_PARAMS_NUM(cnt, para_num);
 
     s_mode = mode;
+    s_passthrough_window_ms = window_ms;
+    s_passthrough_size = size;
 
     return ESP_AT_RESULT_CODE_OK;
 }
@@ -1858,14 +2170,9 @@ static uint8_t at_setup_cmd_rmsend(uint8_t para_num)
     // parameters are ready
     CHECK_PARAMS_NUM(cnt, para_num);
 
-    esp_rmaker_device_t *device = esp_rmaker_node_get_device_by_name(esp_rmaker_get_node(), (const char *)unique_name);
-    if (!device) {
-        //TODO: error code, device not found
-        return ESP_AT_RESULT_CODE_ERROR;
-    }
-    esp_rmaker_param_t *param = esp_rmaker_device_get_param_by_name(device, (const char *)param_name);
+    esp_rmaker_param_t *param = rmaker_get_param((const char *)unique_name, (const char *)param_name);
     if (!param) {
-        //TODO: error code, param not found
+        //TODO: error code, device or param not found
         return ESP_AT_RESULT_CODE_ERROR;
     }
     esp_rmaker_val_type_t type = esp_rmaker_param_get_data_type(param);
@@ -1924,11 +2231,56 @@ static uint8_t at_setup_cmd_rmsend(uint8_t para_num)
     return ESP_AT_RESULT_CODE_SEND_OK;
 }
 
+// Report the passthrough data in <buf>, which has room for a NULL terminator.
+// Numeric values are framed by lines, only the latest complete line is reported
+// and a trailing partial line is held back, unless <flush> is set.
+// Returns the number of bytes consumed.
+static int32_t rmaker_passthrough_report(uint8_t *buf, int32_t len, bool flush)
+{
+    esp_rmaker_param_t *param = s_profile.passthrough_param_handle;
+    esp_rmaker_param_val_t val;
+    memset(&val, 0, sizeof(esp_rmaker_param_val_t));
+    val.type = esp_rmaker_param_get_data_type(param);
+
+    int32_t consumed = len;
+    int32_t begin = 0;
+    int32_t end = len;
+    if ((val.type == RMAKER_VAL_TYPE_BOOLEAN) || (val.type == RMAKER_VAL_TYPE_INTEGER) || (val.type == RMAKER_VAL_TYPE_FLOAT)) {
+        if (!flush) {
+            while ((end > 0) && (buf[end - 1] != '\n')) {
+                end--;
+            }
+            consumed = end;
+        }
+        while ((end > 0) && ((buf[end - 1] == '\r') || (buf[end - 1] == '\n'))) {
+            end--;
+        }
+        if (end == 0) {
+            // no complete line to report
+            return consumed;
+        }
+        begin = end;
+        while ((begin > 0) && (buf[begin - 1] != '\n')) {
+            begin--;
+        }
+    }
+
+    uint8_t last = buf[end];
+    buf[end] = '\0';
+    rmaker_structure_data(val.type, buf + begin, &val);
+    esp_rmaker_param_update_and_report(param, val);
+    buf[end] = last;
+
+    return consumed;
+}
+
 static uint8_t at_exe_cmd_rmsend(uint8_t *cmd_name)
 {
-    int cnt = 0;
     uint8_t *buf;
-    int32_t had_received_len = 0;
+    int32_t buf_len = 0;
+    int32_t held_len = 0;   // partial numeric line already seen by a report
+    int32_t plus_run = 0;
+    TickType_t first_tick = 0;
 
     if (!(xEventGroupGetBits(s_rm_event_group) & RM_NODE_INIT_DONE_EVENT)) {
         //TODO: error code, not init
@@ -1945,8 +2297,8 @@ static uint8_t at_exe_cmd_rmsend(uint8_t *cmd_name)
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
-    // data processing
-    buf = (uint8_t *)calloc(1, RAINMAKER_PASSTHROUGH_BUFFER_LEN);
+    // data processing, +1 for NULL termination
+    buf = (uint8_t *)malloc(s_passthrough_size + 1);
     if (buf == NULL) {
         return ESP_AT_RESULT_CODE_ERROR;
     }
@@ -1962,25 +2314,78 @@ static uint8_t at_exe_cmd_rmsend(uint8_t *cmd_name)
     // output "OK" and ">"
     esp_at_response_result(ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT);
     xEventGroupSetBits(s_rm_event_group, RM_IN_PASSTHROUGH_MODE);
-    // receive at cmd port data
-    while (xSemaphoreTake(s_at_rainmaker_sync_sema, portMAX_DELAY)) {
-        memset(buf, 0, RAINMAKER_PASSTHROUGH_BUFFER_LEN);
-        had_received_len = esp_at_port_read_data(buf, RAINMAKER_PASSTHROUGH_BUFFER_LEN);
-        // Check whether to exit the passthrough mode
-        // the exit condition is the "+++" string received
-        if ((had_received_len == 3) && (strncmp((const char *)buf, "+++", 3) == 0)) {
-            esp_at_port_exit_specific();
-            xEventGroupClearBits(s_rm_event_group, RM_IN_PASSTHROUGH_MODE);
-            break;
-        } else {
-            /* Report to the cloud */
-            esp_rmaker_param_val_t val;
-            memset(&val, 0, sizeof(esp_rmaker_param_val_t));
-            val.type = esp_rmaker_param_get_data_type(s_profile.passthrough_param_handle);
-            rmaker_structure_data(val.type, buf, &val);
-            esp_rmaker_param_update_and_report(s_profile.passthrough_param_handle, val);
+
+    // the data received within the coalescing window or up to the coalescing size is reported at once
+    for (;;) {
+        TickType_t wait_ticks = portMAX_DELAY;
+        if (plus_run == RAINMAKER_PASSTHROUGH_ESCAPE_LEN) {
+            wait_ticks = pdMS_TO_TICKS(RAINMAKER_PASSTHROUGH_ESCAPE_GUARD_MS);
+        } else if (buf_len > held_len) {
+            TickType_t elapsed = xTaskGetTickCount() - first_tick;
+            TickType_t window = pdMS_TO_TICKS(s_passthrough_window_ms);
+            wait_ticks = (window > elapsed) ? (window - elapsed) : 0;
+        }
+
+        if (xSemaphoreTake(s_at_rainmaker_sync_sema, wait_ticks) != pdTRUE) {
+            // the data ends with "+++" and nothing follows, exit the passthrough mode
+            if (plus_run == RAINMAKER_PASSTHROUGH_ESCAPE_LEN) {
+                buf_len -= RAINMAKER_PASSTHROUGH_ESCAPE_LEN;
+                if (buf_len > 0) {
+                    rmaker_passthrough_report(buf, buf_len, true);
+                }
+                break;
+            }
+            // coalescing window expires, a partial numeric line waits for the rest of it
+            int32_t consumed = rmaker_passthrough_report(buf, buf_len, false);
+            buf_len -= consumed;
+            memmove(buf, buf + consumed, buf_len);
+            held_len = buf_len;
+            if (buf_len == 0) {
+                plus_run = 0;
+            }
+            continue;
+        }
+
+        int32_t len = esp_at_port_read_data(buf + buf_len, s_passthrough_size - buf_len);
+        if (len <= 0) {
+            continue;
+        }
+        if (buf_len == held_len) {
+            first_tick = xTaskGetTickCount();
+        }
+
+        // track the trailing '+', so that "+++" split into several reads is still detected
+        for (int32_t i = buf_len; i < buf_len + len; i++) {
+            plus_run = (buf[i] == '+') ? (plus_run + 1) : 0;
+        }
+        buf_len += len;
+
+        if (buf_len == s_passthrough_size) {
+            // report up to the last complete line if any, and hold back the trailing '+' of a possible "+++",
+            // a numeric line that fills the whole buffer cannot be a value and is dropped
+            int32_t report_len = buf_len;
+            while ((report_len > 0) && (buf[report_len - 1] != '\n')) {
+                report_len--;
+            }
+            if (report_len == 0) {
+                report_len = buf_len - at_min(plus_run, RAINMAKER_PASSTHROUGH_ESCAPE_LEN);
+            }
+            rmaker_passthrough_report(buf, report_len, false);
+            buf_len -= report_len;
+            memmove(buf, buf + report_len, buf_len);
+            held_len = 0;
+            first_tick = xTaskGetTickCount();
+        }
+
+        // the data left in the port is not notified again
+        if (esp_at_port_get_data_length() > 0) {
+            xSemaphoreGive(s_at_rainmaker_sync_sema);
         }
     }
+
+    esp_at_port_exit_specific();
+    xEventGroupClearBits(s_rm_event_group, RM_IN_PASSTHROUGH_MODE);
+
     vSemaphoreDelete(s_at_rainmaker_sync_sema);
     s_at_rainmaker_sync_sema = NULL;
     free(buf);
@@ -2093,6 +2498,9 @@ static const esp_at_cmd_struct s_at_rainmaker_cmd[] = {
     {"+RMCONN", NULL, NULL, at_setup_cmd_rmconn, at_exe_cmd_rmconn},
     {"+RMCLOSE", NULL, NULL, NULL, at_setup_cmd_rmclose},
     {"+RMPARAMUPDATE", NULL, NULL, at_setup_cmd_rmparamupdate, NULL},
+    {"+RMPARAMBATCH", NULL, NULL, at_setup_cmd_rmparambatch, NULL},
+    {"+RMREPORTCFG", NULL, at_query_cmd_rmreportcfg, at_setup_cmd_rmreportcfg, NULL},
+    {"+RMRECVSTAT", NULL, at_query_cmd_rmrecvstat, NULL, NULL},
     {"+RMMODE", NULL, NULL, at_setup_cmd_rmmode, NULL},
     {"+RMSEND", NULL, NULL, at_setup_cmd_rmsend, at_exe_cmd_rmsend},
     {"+RMOTARESULT", NULL, NULL, at_setup_cmd_rmotaresult, NULL},
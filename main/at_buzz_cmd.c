@@ -7,6 +7,12 @@
    CONDITIONS OF ANY KIND, either express or implied.
 */
 
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
 #include "driver/ledc.h"
 #include "esp_err.h"
 
@@ -24,12 +30,119 @@ static const char *TAG = "esp_at_buzz_cmd";
 #define LEDC_DUTY               (4096) // Set duty to 50%. (2 ** 13) * 50% = 4096
 #define LEDC_FREQUENCY          (4000) // Frequency in Hertz. Set frequency at 4 kHz
 
+#define BUZZ_FREQ_MIN           20
+#define BUZZ_FREQ_MAX           20000
+#define BUZZ_SEQ_NOTE_NUM       32
+#define BUZZ_SEQ_NOTE_MS_MAX    60000
+#define BUZZ_SEQ_TASK_STACK     2048
+#define BUZZ_SEQ_TASK_PRIORITY  2
+#define BUZZ_SEQ_NOTE_TEXT_MAX  16  // "20000,60000,100,"
+#define BUZZ_SEQ_PAYLOAD_MAX    (BUZZ_SEQ_NOTE_NUM * BUZZ_SEQ_NOTE_TEXT_MAX)
+
+typedef struct {
+    uint16_t freq_hz;       // 0 for a rest
+    uint16_t duration_ms;   // 0 to hold until the next request
+    uint8_t volume;         // 0-100, percent of the 50% duty
+} at_buzz_note_t;
+
+typedef struct {
+    uint32_t loops;         // 0 to repeat forever
+    uint8_t note_num;       // 0 to stop and stay silent
+    at_buzz_note_t notes[BUZZ_SEQ_NOTE_NUM];
+} at_buzz_seq_t;
+
+// All LEDC updates are done by the sequencer task. The commands hand over the
+// latest request under the mutex and notify the task, which interrupts the
+// sequence it is playing.
+static SemaphoreHandle_t buzz_seq_mutex = NULL;
+static TaskHandle_t buzz_seq_task = NULL;
+static at_buzz_seq_t buzz_seq_request;
+
+// AT+BUZZSEQ payload, received after the ">" prompt
+static uint8_t buzz_seq_buf[BUZZ_SEQ_PAYLOAD_MAX];
+static SemaphoreHandle_t buzz_seq_sync_sema = NULL;
+
 /* Warning:
  * For ESP32, ESP32S2, ESP32S3, ESP32C3, ESP32C2, ESP32C6, ESP32H2 (rev < 1.2), ESP32P4 targets,
  * when LEDC_DUTY_RES selects the maximum duty resolution (i.e. value equal to SOC_LEDC_TIMER_BIT_WIDTH),
  * 100% duty cycle is not reachable (duty cannot be set to (2 ** SOC_LEDC_TIMER_BIT_WIDTH)).
  */
 
+static void at_buzz_tone(uint32_t freq_hz, uint32_t volume)
+{
+    if (freq_hz == 0 || volume == 0) {
+        // Stop sound
+        ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0));
+    } else {
+        // Set frequency
+        ESP_ERROR_CHECK(ledc_set_freq(LEDC_MODE, LEDC_TIMER, freq_hz));
+        // Scale the 50% duty by the volume
+        ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, LEDC_DUTY * volume / 100));
+    }
+    // Update duty to apply the new value
+    ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, LEDC_CHANNEL));
+}
+
+// Play <seq> to the end. Note deadlines are absolute, so the timing does not
+// drift over long sequences. Returns true if a new request interrupted it.
+static bool at_buzz_seq_play(const at_buzz_seq_t *seq)
+{
+    bool interrupted = false;
+    TickType_t deadline = xTaskGetTickCount();
+
+    for (uint32_t loop = 0; !interrupted && seq->note_num && (seq->loops == 0 || loop < seq->loops); loop++) {
+        for (int i = 0; i < seq->note_num; i++) {
+            const at_buzz_note_t *note = &seq->notes[i];
+            at_buzz_tone(note->freq_hz, note->volume);
+
+            TickType_t wait = portMAX_DELAY;
+            if (note->duration_ms) {
+                deadline += pdMS_TO_TICKS(note->duration_ms);
+                TickType_t now = xTaskGetTickCount();
+                wait = (int32_t)(deadline - now) > 0 ? deadline - now : 0;
+            }
+            if (ulTaskNotifyTake(pdTRUE, wait)) {
+                interrupted = true;
+                break;
+            }
+        }
+    }
+
+    if (!interrupted) {
+        at_buzz_tone(0, 0);
+    }
+    return interrupted;
+}
+
+static void at_buzz_seq_task(void *arg)
+{
+    at_buzz_seq_t seq;
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (1) {
+        xSemaphoreTake(buzz_seq_mutex, portMAX_DELAY);
+        memcpy(&seq, &buzz_seq_request, sizeof(seq));
+        xSemaphoreGive(buzz_seq_mutex);
+
+        if (at_buzz_seq_play(&seq)) {
+            // a newer request is waiting, start it right away
+            continue;
+        }
+        if (seq.note_num) {
+            esp_at_port_active_write_data((uint8_t *)"+BUZZSEQ:DONE\r\n", strlen("+BUZZSEQ:DONE\r\n"));
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void at_buzz_seq_submit(const at_buzz_seq_t *seq)
+{
+    xSemaphoreTake(buzz_seq_mutex, portMAX_DELAY);
+    memcpy(&buzz_seq_request, seq, sizeof(buzz_seq_request));
+    xSemaphoreGive(buzz_seq_mutex);
+    xTaskNotifyGive(buzz_seq_task);
+}
+
 void at_buzz_init(void)
 {
     // Prepare and then apply the LEDC PWM timer configuration
@@ -53,6 +166,13 @@ void at_buzz_init(void)
         .hpoint         = 0
     };
     ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+
+    buzz_seq_mutex = xSemaphoreCreateMutex();
+    if (!buzz_seq_mutex || xTaskCreate(at_buzz_seq_task, "buzz_seq", BUZZ_SEQ_TASK_STACK, NULL,
+                                       BUZZ_SEQ_TASK_PRIORITY, &buzz_seq_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create buzzer sequencer task");
+        ESP_ERROR_CHECK(ESP_ERR_NO_MEM);
+    }
 }
 
 static uint8_t at_setup_cmd_buzz(uint8_t para_num)
@@ -63,32 +183,133 @@ static uint8_t at_setup_cmd_buzz(uint8_t para_num)
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
-    if (digit == 0) {
-        // Stop sound
-        ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0));
-        // Update duty to apply the new value
-        ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, LEDC_CHANNEL));
+    // a single tone is a one note sequence held until the next request,
+    // it also stops a running sequence
+    at_buzz_seq_t seq = {0};
+    if (digit != 0) {
+        if (digit < BUZZ_FREQ_MIN || digit > BUZZ_FREQ_MAX) {
+            ESP_LOGE(TAG, "Frequency value out of range (20-20000): %d", digit);
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        seq.loops = 1;
+        seq.note_num = 1;
+        seq.notes[0].freq_hz = digit;
+        seq.notes[0].volume = 100;
+    }
+    at_buzz_seq_submit(&seq);
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// Parse "<freq>,<ms>,<volume>[,<freq>,<ms>,<volume>...]" into the notes of <seq>,
+// a trailing line break is ignored. Returns 0 on success, or -1 on error.
+static int at_buzz_seq_parse(const uint8_t *data, int32_t len, at_buzz_seq_t *seq)
+{
+    int32_t values[3];
+    int field = 0;
+    int32_t i = 0;
 
-        return ESP_AT_RESULT_CODE_OK;
+    while (len > 0 && (data[len - 1] == '\r' || data[len - 1] == '\n')) {
+        len--;
     }
 
-    if (digit < 20 || digit > 20000) {
-        ESP_LOGE(TAG, "Frequency value out of range (20-20000): %d", digit);
+    seq->note_num = 0;
+    while (i < len) {
+        int32_t value = 0, digits = 0;
+        while (i < len && data[i] >= '0' && data[i] <= '9') {
+            if (++digits > 5) {
+                return -1;
+            }
+            value = value * 10 + (data[i++] - '0');
+        }
+        if (digits == 0) {
+            return -1;
+        }
+        if (i < len && (data[i++] != ',' || i == len)) {
+            return -1;
+        }
+
+        values[field++] = value;
+        if (field < 3) {
+            continue;
+        }
+        field = 0;
+        if (seq->note_num >= BUZZ_SEQ_NOTE_NUM) {
+            return -1;
+        }
+        if ((values[0] != 0 && (values[0] < BUZZ_FREQ_MIN || values[0] > BUZZ_FREQ_MAX))
+                || values[1] <= 0 || values[1] > BUZZ_SEQ_NOTE_MS_MAX || values[2] > 100) {
+            return -1;
+        }
+        seq->notes[seq->note_num].freq_hz = values[0];
+        seq->notes[seq->note_num].duration_ms = values[1];
+        seq->notes[seq->note_num].volume = values[2];
+        seq->note_num++;
+    }
+
+    return (field == 0 && seq->note_num > 0) ? 0 : -1;
+}
+
+static void at_buzz_seq_wait_data_cb(void)
+{
+    xSemaphoreGive(buzz_seq_sync_sema);
+}
+
+// AT+BUZZSEQ=<loops>,<length>
+// <loops> 0 to repeat forever, <length> the number of payload bytes that follow
+// the ">" prompt. The payload lists up to BUZZ_SEQ_NOTE_NUM notes as
+// "<freq>,<ms>,<volume>[,<freq>,<ms>,<volume>...]": the frequency (0 for a rest
+// or 20-20000 Hz), the duration 1-60000 ms and the volume 0-100.
+// "+BUZZSEQ:DONE" is reported when the sequence ends, AT+BUZZ stops it.
+static uint8_t at_setup_cmd_buzzseq(uint8_t para_num)
+{
+    at_buzz_seq_t seq = {0};
+    int32_t loops = 0, length = 0;
+    int32_t cnt = 0;
+
+    if (esp_at_get_para_as_digit(cnt++, &loops) != ESP_AT_PARA_PARSE_RESULT_OK || loops < 0) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (esp_at_get_para_as_digit(cnt++, &length) != ESP_AT_PARA_PARSE_RESULT_OK
+            || length <= 0 || length > BUZZ_SEQ_PAYLOAD_MAX) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (cnt != para_num) {
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
-    // Set frequency
-    ESP_ERROR_CHECK(ledc_set_freq(LEDC_MODE, LEDC_TIMER, digit));
-    // Set duty to 50%
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, LEDC_DUTY));
-    // Update duty to apply the new value
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, LEDC_CHANNEL));
+    if (!buzz_seq_sync_sema) {
+        buzz_seq_sync_sema = xSemaphoreCreateBinary();
+        if (!buzz_seq_sync_sema) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    int32_t received_len = 0;
+    esp_at_port_enter_specific(at_buzz_seq_wait_data_cb);
+    esp_at_response_result(ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT);
+
+    while (xSemaphoreTake(buzz_seq_sync_sema, portMAX_DELAY)) {
+        received_len += esp_at_port_read_data(buzz_seq_buf + received_len, length - received_len);
+        if (received_len == length) {
+            break;
+        }
+    }
+    esp_at_port_exit_specific();
+
+    if (at_buzz_seq_parse(buzz_seq_buf, length, &seq) < 0) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    seq.loops = loops;
+    at_buzz_seq_submit(&seq);
 
     return ESP_AT_RESULT_CODE_OK;
 }
 
 static const esp_at_cmd_struct at_buzz_cmd[] = {
     {"+BUZZ", NULL, NULL, at_setup_cmd_buzz, NULL},
+    {"+BUZZSEQ", NULL, NULL, at_setup_cmd_buzzseq, NULL},
 };
 
 bool esp_at_buzz_cmd_regist(void)
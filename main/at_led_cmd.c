@@ -7,25 +7,121 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 // #define LOG_LOCAL_LEVEL ESP_LOG_VERBOSE
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
 #include "esp_at.h"
 
+#include "soc/soc_caps.h"
 #include "driver/rmt_tx.h"
 
 #define RMT_LED_STRIP_RESOLUTION_HZ 10000000 // 10MHz resolution, 1 tick = 0.1us (led strip needs a high resolution)
 #define RMT_LED_STRIP_GPIO_NUM      5        // Pin 10 / MTDI / GPIO5
 
+#if SOC_RMT_SUPPORT_DMA
+#define RMT_LED_STRIP_MEM_SYMBOLS   1024     // DMA buffer, 24 symbols per LED: 42 LEDs, 21 per ping-pong half refill
+#else
+#define RMT_LED_STRIP_MEM_SYMBOLS   64       // increase the block size can make the LED less flickering
+#endif
+
 #define MAX_LED_NUMBERS             256
 #define DEFAULT_LED_NUMBERS         4
 
+#define LED_FLUSH_TASK_STACK_SIZE   2048
+#define LED_FLUSH_TASK_PRIORITY     1
+
+#define LED_ANIM_KEYFRAME_NUM       8
+#define LED_ANIM_STEP_NUM           ((ESP_AT_PARA_NUM_MAX - 3) / 2)  // <fps>,<loops>,<curve> then <keyframe>,<ms> pairs
+#define LED_ANIM_FPS_MAX            100
+#define LED_ANIM_STEP_MS_MAX        60000
+#define LED_ANIM_CURVE_LINEAR       0        // interpolate the output values
+#define LED_ANIM_CURVE_GAMMA        1        // interpolate perceived brightness
+
+#define LED_FRAME_MODE_BINARY       0        // raw pixel bytes
+#define LED_FRAME_MODE_HEX          1        // two hex characters per pixel byte
+
+// pixel formats accepted by +LED, +LEDFRAME and +LEDKEY, multi-byte pixels are big endian
+#define LED_FORMAT_RGB332           0
+#define LED_FORMAT_RGB565           1
+#define LED_FORMAT_RGB888           2
+#define LED_FORMAT_GRB888           3
+#define LED_FORMAT_MAX              4
+
+// channel order on the wire
+#define LED_ORDER_GRB               0        // WS2812
+#define LED_ORDER_RGB               1
+#define LED_ORDER_GRBW              2        // SK6812 RGBW, white is extracted from the common part
+#define LED_ORDER_MAX               3
+#define LED_MAX_CHANNELS            4
+
+#define LED_GAMMA_MIN               100      // gamma values are in 1/100 units
+#define LED_GAMMA_MAX               300
+#define LED_GAMMA_DEFAULT           220
+
 static const char *TAG = "esp_at_led_cmd";
 
+// back buffer of RGB light levels, written by the AT commands
 static uint8_t led_strip_pixels[MAX_LED_NUMBERS * 3];
+// front buffer in the wire format, owned by the flush task while RMT transmits it
+static uint8_t led_tx_pixels[MAX_LED_NUMBERS * LED_MAX_CHANNELS];
 
 static unsigned int led_used_no = 0;
 
+// protects the back buffer, the pending frame and the statistics
+static SemaphoreHandle_t led_buf_mutex = NULL;
+static TaskHandle_t led_flush_task = NULL;
+static unsigned int led_pending_count = 0;  // LEDs of the frame waiting for the flush task, 0 if none
+static uint32_t led_frames_sent = 0;
+static uint32_t led_frames_dropped = 0;
+static uint32_t led_last_frame_us = 0;
+
+// a stored frame covering the LEDs [start, start + count)
+typedef struct {
+    uint16_t start;
+    uint16_t count;
+    uint8_t *rgb;               // count RGB triplets, NULL if the slot is empty
+} at_led_keyframe_t;
+
+typedef struct {
+    uint8_t keyframe;
+    uint32_t duration_ms;       // fade time from the previous step's keyframe
+} at_led_anim_step_t;
+
+typedef struct {
+    bool running;
+    uint8_t curve;
+    uint16_t fps;
+    uint32_t loops;             // 0 to repeat forever
+    uint8_t step_num;
+    at_led_anim_step_t steps[LED_ANIM_STEP_NUM];
+    uint32_t cycle_ms;          // sum of the step durations
+    int64_t start_us;
+} at_led_anim_t;
+
+// keyframes and animation state are protected by the buffer lock as well
+static at_led_keyframe_t led_keyframes[LED_ANIM_KEYFRAME_NUM];
+static at_led_anim_t led_anim;
+static esp_timer_handle_t led_anim_timer = NULL;
+static const uint8_t led_format_bytes[LED_FORMAT_MAX] = { 1, 2, 3, 3 };
+static uint8_t led_format = LED_FORMAT_RGB332;
+// the order, brightness and LUTs are read by the flush task under the buffer lock
+static uint8_t led_order = LED_ORDER_GRB;
+static uint8_t led_brightness = 255;
+static uint16_t led_gamma = LED_GAMMA_DEFAULT;
+static uint8_t led_gamma_lut[256];
+static uint8_t led_degamma_lut[256];
+static uint8_t led_bright_lut[256];
+
+// raw frame payload, large enough for a full strip of 3 byte pixels in hex mode
+static uint8_t led_frame_buf[MAX_LED_NUMBERS * 3 * 2];
+static SemaphoreHandle_t led_frame_sync_sema = NULL;
+
 static rmt_channel_handle_t led_chan = NULL;
 static rmt_encoder_handle_t simple_encoder = NULL;
 
@@ -51,42 +147,48 @@ static const rmt_symbol_word_t ws2812_reset = {
     .duration1 = RMT_LED_STRIP_RESOLUTION_HZ / 1000000 * 50 / 2,
 };
 
+// Pre-encoded WS2812 symbols for every nibble value, MSB first. A byte is
+// encoded by copying the entries of its two nibbles, which keeps the table at
+// 256 bytes instead of 8KB for a full per-byte table.
+static rmt_symbol_word_t led_nibble_symbols[16][4];
+
+static void at_led_symbol_lut_init(void)
+{
+    for (int nibble = 0; nibble < 16; nibble++) {
+        for (int bit = 0; bit < 4; bit++) {
+            led_nibble_symbols[nibble][bit] = (nibble & (0x8 >> bit)) ? ws2812_one : ws2812_zero;
+        }
+    }
+}
+
 static size_t encoder_callback(const void *data, size_t data_size,
                                size_t symbols_written, size_t symbols_free,
                                rmt_symbol_word_t *symbols, bool *done, void *arg)
 {
-    // ESP_LOGI(TAG, "encode_callback: data_size=%d, symbols_written=%d, symbols_free=%d", data_size, symbols_written, symbols_free);
-    // We need a minimum of 8 symbol spaces to encode a byte. We only
-    // need one to encode a reset, but it's simpler to simply demand that
-    // there are 8 symbol spaces free to write anything.
-    if (symbols_free < 8) {
-        return 0;
+    // Every byte takes 8 symbols and the reset takes one. Encode as many
+    // whole bytes as fit into the free space in one call, and append the
+    // reset as soon as there is room for it after the last byte.
+    size_t data_pos = symbols_written / 8;
+    const uint8_t *data_bytes = (const uint8_t *)data;
+    size_t bytes = symbols_free / 8;
+    if (bytes > data_size - data_pos) {
+        bytes = data_size - data_pos;
     }
 
-    // We can calculate where in the data we are from the symbol pos.
-    // Alternatively, we could use some counter referenced by the arg
-    // parameter to keep track of this.
-    size_t data_pos = symbols_written / 8;
-    uint8_t *data_bytes = (uint8_t*)data;
-    if (data_pos < data_size) {
-        // Encode a byte
-        size_t symbol_pos = 0;
-        for (int bitmask = 0x80; bitmask != 0; bitmask >>= 1) {
-            if (data_bytes[data_pos]&bitmask) {
-                symbols[symbol_pos++] = ws2812_one;
-            } else {
-                symbols[symbol_pos++] = ws2812_zero;
-            }
-        }
-        // We're done; we should have written 8 symbols.
-        return symbol_pos;
-    } else {
-        //All bytes already are encoded.
-        //Encode the reset, and we're done.
-        symbols[0] = ws2812_reset;
+    size_t symbol_pos = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        uint8_t value = data_bytes[data_pos + i];
+        memcpy(&symbols[symbol_pos], led_nibble_symbols[value >> 4], sizeof(led_nibble_symbols[0]));
+        memcpy(&symbols[symbol_pos + 4], led_nibble_symbols[value & 0xf], sizeof(led_nibble_symbols[0]));
+        symbol_pos += 8;
+    }
+
+    if (data_pos + bytes == data_size && symbol_pos < symbols_free) {
+        //All bytes are encoded. Encode the reset, and we're done.
+        symbols[symbol_pos++] = ws2812_reset;
         *done = 1; //Indicate end of the transaction.
-        return 1; //we only wrote one symbol
     }
+    return symbol_pos;
 }
 
 void at_led_set_value(uint8_t led_no, uint8_t red, uint8_t green, uint8_t blue)
@@ -95,32 +197,202 @@ void at_led_set_value(uint8_t led_no, uint8_t red, uint8_t green, uint8_t blue)
         ESP_LOGE(TAG, "LED number %d is out of range", led_no);
         return;
     }
-    led_strip_pixels[led_no * 3 + 0] = green;
-    led_strip_pixels[led_no * 3 + 1] = red;
+    led_strip_pixels[led_no * 3 + 0] = red;
+    led_strip_pixels[led_no * 3 + 1] = green;
     led_strip_pixels[led_no * 3 + 2] = blue;
     if (led_no >= led_used_no) {
         led_used_no = led_no + 1;
     }
 }
 
-static void at_led_flush_no(uint8_t count) {
+// Recompute the tables for the current gamma and brightness, only done when they change.
+static void at_led_lut_update(void)
+{
+    float gamma = led_gamma / 100.0f;
+    for (int i = 0; i < 256; i++) {
+        led_gamma_lut[i] = (uint8_t)(powf(i / 255.0f, gamma) * 255.0f + 0.5f);
+        led_degamma_lut[i] = (uint8_t)(powf(i / 255.0f, 1.0f / gamma) * 255.0f + 0.5f);
+        led_bright_lut[i] = (uint8_t)((i * led_brightness + 127) / 255);
+    }
+}
+
+// Convert <count> LEDs of the back buffer into the wire format of the strip.
+// Returns the number of bytes to transmit.
+static size_t at_led_output_convert(unsigned int count)
+{
+    uint8_t *out = led_tx_pixels;
+
+    for (unsigned int i = 0; i < count; i++) {
+        uint8_t r = led_bright_lut[led_strip_pixels[i * 3 + 0]];
+        uint8_t g = led_bright_lut[led_strip_pixels[i * 3 + 1]];
+        uint8_t b = led_bright_lut[led_strip_pixels[i * 3 + 2]];
+
+        if (led_order == LED_ORDER_RGB) {
+            *out++ = r;
+            *out++ = g;
+            *out++ = b;
+        } else if (led_order == LED_ORDER_GRBW) {
+            uint8_t w = at_min(r, at_min(g, b));
+            *out++ = g - w;
+            *out++ = r - w;
+            *out++ = b - w;
+            *out++ = w;
+        } else {
+            *out++ = g;
+            *out++ = r;
+            *out++ = b;
+        }
+    }
+    return out - led_tx_pixels;
+}
+
+// progress is in 1/256 units, 0 gives <from> and 256 gives <to>
+static uint8_t at_led_anim_blend(uint8_t from, uint8_t to, uint32_t progress, uint8_t curve)
+{
+    if (progress == 0) {
+        return from;
+    } else if (progress >= 256) {
+        return to;
+    }
+
+    if (curve == LED_ANIM_CURVE_GAMMA) {
+        int32_t a = led_degamma_lut[from];
+        int32_t b = led_degamma_lut[to];
+        return led_gamma_lut[a + (b - a) * (int32_t)progress / 256];
+    }
+    return from + ((int32_t)to - from) * (int32_t)progress / 256;
+}
+
+// Blend keyframe <from_id> into <to_id> over the LEDs covered by <to_id>.
+// LEDs outside the window of <from_id> fade in from off.
+static void at_led_anim_blend_keyframes(uint8_t from_id, uint8_t to_id, uint32_t progress, uint8_t curve)
+{
+    static const uint8_t off[3] = {0};
+    const at_led_keyframe_t *from = &led_keyframes[from_id];
+    const at_led_keyframe_t *to = &led_keyframes[to_id];
+
+    for (int i = 0; i < to->count; i++) {
+        unsigned int led = to->start + i;
+        const uint8_t *b = &to->rgb[i * 3];
+        const uint8_t *a = off;
+        if (from->rgb && led >= from->start && led < from->start + from->count) {
+            a = &from->rgb[(led - from->start) * 3];
+        }
+        at_led_set_value(led, at_led_anim_blend(a[0], b[0], progress, curve),
+                         at_led_anim_blend(a[1], b[1], progress, curve),
+                         at_led_anim_blend(a[2], b[2], progress, curve));
+    }
+}
+
+// Render the animation state at <elapsed_ms> since its start into the back buffer.
+// Returns false once all loops have been played, the last keyframe is rendered then.
+static bool at_led_anim_render(uint32_t elapsed_ms)
+{
+    uint8_t n = led_anim.step_num;
+
+    if (led_anim.loops && elapsed_ms / led_anim.cycle_ms >= led_anim.loops) {
+        at_led_anim_blend_keyframes(led_anim.steps[n - 1].keyframe, led_anim.steps[n - 1].keyframe, 256, led_anim.curve);
+        return false;
+    }
+
+    // every step fades from the keyframe of the step before it, the first one
+    // from the last step so that the sequence loops seamlessly
+    uint32_t t = elapsed_ms % led_anim.cycle_ms;
+    uint8_t i = 0;
+    while (t >= led_anim.steps[i].duration_ms) {
+        t -= led_anim.steps[i].duration_ms;
+        i++;
+    }
+    uint32_t progress = t * 256 / led_anim.steps[i].duration_ms;
+    at_led_anim_blend_keyframes(led_anim.steps[(i + n - 1) % n].keyframe, led_anim.steps[i].keyframe,
+                                progress, led_anim.curve);
+    return true;
+}
+
+static void at_led_anim_timer_cb(void *arg)
+{
+    xTaskNotifyGive(led_flush_task);
+}
+
+static void at_led_lock(void)
+{
+    xSemaphoreTake(led_buf_mutex, portMAX_DELAY);
+}
+
+static void at_led_unlock(void)
+{
+    xSemaphoreGive(led_buf_mutex);
+}
+
+// Queue the back buffer for transmission and return immediately.
+// Must be called with the buffer lock held. A frame still waiting for the
+// flush task is superseded by the new one and counted as dropped.
+static void at_led_flush_no(unsigned int count) {
     if (count > led_used_no) {
         count = led_used_no;
     }
-    ESP_LOGI(TAG, "Flush %d LEDs", count);
+    ESP_LOGD(TAG, "Flush %d LEDs", count);
+
+    if (led_pending_count) {
+        led_frames_dropped++;
+    }
+    led_pending_count = count;
+    xTaskNotifyGive(led_flush_task);
+}
 
+// Swap the pending frame (or the next animation frame) into the front buffer and transmit it.
+static void at_led_flush_frame(void)
+{
     rmt_transmit_config_t tx_config = {
         .loop_count = 0, // no transfer loop
     };
-    ESP_ERROR_CHECK(rmt_tx_wait_all_done(led_chan, portMAX_DELAY));
+
+    // swap: take a snapshot of the back buffer so the commands can keep writing
+    bool anim_done = false;
+    at_led_lock();
+    if (led_anim.running) {
+        anim_done = !at_led_anim_render((uint32_t)((esp_timer_get_time() - led_anim.start_us) / 1000));
+        led_anim.running = !anim_done;
+        led_pending_count = led_used_no;
+    }
+    if (anim_done) {
+        // under the lock, so an animation started meanwhile keeps its timer and is not reported as done
+        esp_timer_stop(led_anim_timer);
+        esp_at_port_active_write_data((uint8_t *)"+LEDANIM:DONE\r\n", strlen("+LEDANIM:DONE\r\n"));
+    }
+    unsigned int count = led_pending_count;
+    led_pending_count = 0;
+    size_t bytes = at_led_output_convert(count);
+    at_led_unlock();
+
+    if (count == 0) {
+        return;
+    }
+
+    int64_t start_us = esp_timer_get_time();
     ESP_ERROR_CHECK(rmt_transmit(led_chan,
         simple_encoder,
-        led_strip_pixels,
-        count * 3,
+        led_tx_pixels,
+        bytes,
         &tx_config));
+    ESP_ERROR_CHECK(rmt_tx_wait_all_done(led_chan, portMAX_DELAY));
+
+    at_led_lock();
+    led_last_frame_us = (uint32_t)(esp_timer_get_time() - start_us);
+    led_frames_sent++;
+    at_led_unlock();
+}
+
+static void at_led_flush_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        at_led_flush_frame();
+    }
 }
 
 void at_led_clear_all(void) {
+    at_led_lock();
     memset(led_strip_pixels, 0, sizeof(led_strip_pixels));
     led_used_no = 0;
         ESP_LOGI(TAG, "Clear %d LEDs", DEFAULT_LED_NUMBERS);
@@ -130,6 +402,7 @@ void at_led_clear_all(void) {
 
     ESP_LOGI(TAG, "Set default values %d LEDs", led_used_no);
     at_led_flush_no(DEFAULT_LED_NUMBERS * 3);
+    at_led_unlock();
 }
 
 void at_led_init(void)
@@ -138,22 +411,35 @@ void at_led_init(void)
     rmt_tx_channel_config_t tx_chan_config = {
         .clk_src = RMT_CLK_SRC_DEFAULT, // select source clock
         .gpio_num = RMT_LED_STRIP_GPIO_NUM,
-        .mem_block_symbols = 64, // increase the block size can make the LED less flickering
+        .mem_block_symbols = RMT_LED_STRIP_MEM_SYMBOLS,
         .resolution_hz = RMT_LED_STRIP_RESOLUTION_HZ,
         .trans_queue_depth = 4, // set the number of transactions that can be pending in the background
+#if SOC_RMT_SUPPORT_DMA
+        .flags.with_dma = true, // refill from memory without CPU gaps on long strips
+#endif
     };
     ESP_ERROR_CHECK(rmt_new_tx_channel(&tx_chan_config, &led_chan));
 
-    ESP_LOGI(TAG, "Create simple callback-based encoder");
+    ESP_LOGI(TAG, "Create bulk callback-based encoder");
+    at_led_symbol_lut_init();
     const rmt_simple_encoder_config_t simple_encoder_cfg = {
-        .callback = encoder_callback
-        //Note we don't set min_chunk_size here as the default of 64 is good enough.
+        .callback = encoder_callback,
+        .min_chunk_size = 8, // one byte is the smallest unit the callback can encode
     };
     ESP_ERROR_CHECK(rmt_new_simple_encoder(&simple_encoder_cfg, &simple_encoder));
 
+    at_led_lut_update();
+
     ESP_LOGI(TAG, "Enable RMT TX channel");
     ESP_ERROR_CHECK(rmt_enable(led_chan));
 
+    led_buf_mutex = xSemaphoreCreateMutex();
+    if (!led_buf_mutex || xTaskCreate(at_led_flush_task, "led_flush", LED_FLUSH_TASK_STACK_SIZE, NULL,
+                                      LED_FLUSH_TASK_PRIORITY, &led_flush_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create LED flush task");
+        ESP_ERROR_CHECK(ESP_ERR_NO_MEM);
+    }
+
     at_led_clear_all();
 }
 
@@ -165,39 +451,460 @@ static const uint8_t LUT3[8] = { 0, 2, 7, 25, 57, 106, 171, 255 };
 // 2-bit channel (B)
 static const uint8_t LUT2[4] = { 0, 2, 57, 255 };
 
+// Convert a pixel in the configured format into RGB light levels.
+// RGB332 codes go through the tables above, which already include the gamma;
+// the wider formats are gamma corrected with the runtime table.
+static void at_led_pixel_to_rgb(uint32_t value, uint8_t rgb[3])
+{
+    switch (led_format) {
+    case LED_FORMAT_RGB565: {
+        uint8_t r5 = (value >> 11) & 0x1f, g6 = (value >> 5) & 0x3f, b5 = value & 0x1f;
+        rgb[0] = led_gamma_lut[(r5 << 3) | (r5 >> 2)];
+        rgb[1] = led_gamma_lut[(g6 << 2) | (g6 >> 4)];
+        rgb[2] = led_gamma_lut[(b5 << 3) | (b5 >> 2)];
+        break;
+    }
+    case LED_FORMAT_RGB888:
+        rgb[0] = led_gamma_lut[(value >> 16) & 0xff];
+        rgb[1] = led_gamma_lut[(value >> 8) & 0xff];
+        rgb[2] = led_gamma_lut[value & 0xff];
+        break;
+    case LED_FORMAT_GRB888:
+        rgb[0] = led_gamma_lut[(value >> 8) & 0xff];
+        rgb[1] = led_gamma_lut[(value >> 16) & 0xff];
+        rgb[2] = led_gamma_lut[value & 0xff];
+        break;
+    default:
+        rgb[0] = LUT3[(value >> 5) & 0x7];
+        rgb[1] = LUT3[(value >> 2) & 0x7];
+        rgb[2] = LUT2[value & 0x3];
+        break;
+    }
+}
+
+static uint32_t at_led_pixel_from_bytes(const uint8_t *data)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < led_format_bytes[led_format]; i++) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+static void at_led_set_pixel(unsigned int led_no, uint32_t value)
+{
+    uint8_t rgb[3];
+    at_led_pixel_to_rgb(value, rgb);
+    ESP_LOGD(TAG, "Set LED %d to %06x / %d,%d,%d", led_no, value, rgb[0], rgb[1], rgb[2]);
+
+    at_led_set_value(led_no, rgb[0], rgb[1], rgb[2]);
+}
+
+static int at_led_hex_nibble(uint8_t c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Decode a received frame payload in place into raw pixel bytes.
+ *
+ * @return number of decoded bytes, or -1 if the payload is malformed
+ */
+static int at_led_frame_decode(uint8_t *data, int len, int mode)
+{
+    if (mode == LED_FRAME_MODE_BINARY) {
+        return len;
+    }
+
+    if (len % 2) {
+        return -1;
+    }
+    for (int i = 0; i < len / 2; i++) {
+        int hi = at_led_hex_nibble(data[i * 2]);
+        int lo = at_led_hex_nibble(data[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return -1;
+        }
+        data[i] = (hi << 4) | lo;
+    }
+    return len / 2;
+}
+
+static void at_led_frame_wait_data_cb(void)
+{
+    xSemaphoreGive(led_frame_sync_sema);
+}
+
+// AT+LED=<pixel>[,<pixel>...] sets up to ESP_AT_PARA_NUM_MAX pixels from index 0,
+// longer strips are written with AT+LEDFRAME.
 static uint8_t at_setup_cmd_led(uint8_t para_num)
 {
     unsigned int index = 0;
 
+    if (para_num > ESP_AT_PARA_NUM_MAX) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    at_led_lock();
+
     // parse all provided digit parameters
     int32_t digit = 0;
-    while (index < MAX_LED_NUMBERS && esp_at_get_para_as_digit(index, &digit) == ESP_AT_PARA_PARSE_RESULT_OK) {
-        if (digit < 0 || digit > 255) {
+    int32_t digit_max = (1 << (8 * led_format_bytes[led_format])) - 1;
+    while (index < para_num && esp_at_get_para_as_digit(index, &digit) == ESP_AT_PARA_PARSE_RESULT_OK) {
+        if (digit < 0 || digit > digit_max) {
+            at_led_unlock();
             return ESP_AT_RESULT_CODE_ERROR;
         }
 
-        // convert RGB332 to separate R, G, B values
-        uint8_t r8 = LUT3[(digit >> 5) & 0x7];
-        uint8_t g8 = LUT3[(digit >> 2) & 0x7];
-        uint8_t b8 = LUT2[digit & 0x3];
-        ESP_LOGI(TAG, "Set LED %d to %02x / %d,%d,%d", index, digit, r8, g8, b8);
-
-        at_led_set_value(index, r8, g8, b8);
+        at_led_set_pixel(index, digit);
         index++;
     }
 
     // fail if nothing parsed
     if (index == 0) {
+        at_led_unlock();
         return ESP_AT_RESULT_CODE_ERROR;
     }
 
     at_led_flush_no(index);
+    at_led_unlock();
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// Parse <length>[,<start>[,<mode>]] from parameter <cnt> on and receive the
+// payload after the ">" prompt into led_frame_buf.
+// Returns the number of received pixels, or -1 on error.
+static int at_led_frame_receive(int32_t cnt, uint8_t para_num, int32_t *start_out)
+{
+    int32_t length = 0, start = 0, mode = LED_FRAME_MODE_BINARY;
+
+    if (esp_at_get_para_as_digit(cnt++, &length) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return -1;
+    }
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &start) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return -1;
+        }
+    }
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &mode) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return -1;
+        }
+    }
+    if (cnt != para_num) {
+        return -1;
+    }
+
+    if (mode != LED_FRAME_MODE_BINARY && mode != LED_FRAME_MODE_HEX) {
+        return -1;
+    }
+    int32_t pixel_bytes = led_format_bytes[led_format];
+    int32_t data_len = (mode == LED_FRAME_MODE_HEX) ? length / 2 : length;
+    if (length <= 0 || (mode == LED_FRAME_MODE_HEX && (length % 2)) || (data_len % pixel_bytes)
+            || start < 0 || start + data_len / pixel_bytes > MAX_LED_NUMBERS) {
+        return -1;
+    }
+
+    if (!led_frame_sync_sema) {
+        led_frame_sync_sema = xSemaphoreCreateBinary();
+        if (!led_frame_sync_sema) {
+            return -1;
+        }
+    }
+
+    int32_t received_len = 0;
+    esp_at_port_enter_specific(at_led_frame_wait_data_cb);
+    esp_at_response_result(ESP_AT_RESULT_CODE_OK_AND_INPUT_PROMPT);
+
+    while (xSemaphoreTake(led_frame_sync_sema, portMAX_DELAY)) {
+        received_len += esp_at_port_read_data(led_frame_buf + received_len, length - received_len);
+        if (received_len == length) {
+            break;
+        }
+    }
+    esp_at_port_exit_specific();
+
+    *start_out = start;
+    if (at_led_frame_decode(led_frame_buf, length, mode) < 0) {
+        return -1;
+    }
+    return data_len / pixel_bytes;
+}
+
+// AT+LEDFRAME=<length>[,<start>[,<mode>]]
+// <length> is the number of payload bytes that follow the ">" prompt,
+// <start> the index of the first LED to update (later LEDs keep their values),
+// <mode> 0 for raw pixel bytes (default), 1 for hex encoded pixel bytes,
+// the pixels are in the format selected by AT+LEDCFG.
+static uint8_t at_setup_cmd_ledframe(uint8_t para_num)
+{
+    int32_t start = 0;
+    int decoded = at_led_frame_receive(0, para_num, &start);
+    if (decoded < 0) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    // a WS2812 chain cannot be addressed at an offset, so the LEDs in front of
+    // the updated window are resent with their current values
+    at_led_lock();
+    for (int i = 0; i < decoded; i++) {
+        at_led_set_pixel(start + i, at_led_pixel_from_bytes(&led_frame_buf[i * led_format_bytes[led_format]]));
+    }
+    at_led_flush_no(start + decoded);
+    at_led_unlock();
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// AT+LEDKEY=<slot>,<length>[,<start>[,<mode>]]
+// Store a keyframe for AT+LEDANIM, the payload is the same as for AT+LEDFRAME.
+// A keyframe only covers the LEDs it was given, so segments of the strip can
+// be animated independently of the rest.
+static uint8_t at_setup_cmd_ledkey(uint8_t para_num)
+{
+    int32_t slot = 0, start = 0;
+
+    if (esp_at_get_para_as_digit(0, &slot) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (slot < 0 || slot >= LED_ANIM_KEYFRAME_NUM) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    int decoded = at_led_frame_receive(1, para_num, &start);
+    if (decoded <= 0) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    uint8_t *rgb = (uint8_t *)malloc(decoded * 3);
+    if (!rgb) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    for (int i = 0; i < decoded; i++) {
+        at_led_pixel_to_rgb(at_led_pixel_from_bytes(&led_frame_buf[i * led_format_bytes[led_format]]), &rgb[i * 3]);
+    }
+
+    at_led_lock();
+    if (led_anim.running) {
+        // keyframes in use cannot be replaced while the animation renders them
+        at_led_unlock();
+        free(rgb);
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    free(led_keyframes[slot].rgb);
+    led_keyframes[slot].rgb = rgb;
+    led_keyframes[slot].start = start;
+    led_keyframes[slot].count = decoded;
+    at_led_unlock();
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// AT+LEDANIM=0 stops the animation.
+// AT+LEDANIM=<fps>,<loops>,<curve>,<keyframe>,<ms>[,<keyframe>,<ms>...] starts it:
+// <fps> frame rate 1-100, <loops> 0 to repeat forever, <curve> 0 linear, 1 gamma aware,
+// and for up to LED_ANIM_STEP_NUM steps the keyframe to fade to and the fade time in milliseconds.
+// "+LEDANIM:DONE" is reported when a finite animation ends.
+static uint8_t at_setup_cmd_ledanim(uint8_t para_num)
+{
+    int32_t fps = 0, loops = 0, curve = 0;
+    int32_t cnt = 0;
+    at_led_anim_t anim = {0};
+
+    if (para_num > ESP_AT_PARA_NUM_MAX) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (esp_at_get_para_as_digit(cnt++, &fps) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (fps == 0 && cnt == para_num) {
+        at_led_lock();
+        if (led_anim_timer) {
+            esp_timer_stop(led_anim_timer);
+        }
+        led_anim.running = false;
+        at_led_unlock();
+        return ESP_AT_RESULT_CODE_OK;
+    }
+    if (fps < 1 || fps > LED_ANIM_FPS_MAX) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    if (esp_at_get_para_as_digit(cnt++, &loops) != ESP_AT_PARA_PARSE_RESULT_OK || loops < 0) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (esp_at_get_para_as_digit(cnt++, &curve) != ESP_AT_PARA_PARSE_RESULT_OK
+            || (curve != LED_ANIM_CURVE_LINEAR && curve != LED_ANIM_CURVE_GAMMA)) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    while (cnt < para_num) {
+        int32_t key = 0, ms = 0;
+        if (anim.step_num >= LED_ANIM_STEP_NUM) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (esp_at_get_para_as_digit(cnt++, &key) != ESP_AT_PARA_PARSE_RESULT_OK
+                || esp_at_get_para_as_digit(cnt++, &ms) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        if (key < 0 || key >= LED_ANIM_KEYFRAME_NUM || ms <= 0 || ms > LED_ANIM_STEP_MS_MAX) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+        anim.steps[anim.step_num].keyframe = key;
+        anim.steps[anim.step_num].duration_ms = ms;
+        anim.cycle_ms += ms;
+        anim.step_num++;
+    }
+    if (cnt != para_num || anim.step_num == 0) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    if (!led_anim_timer) {
+        esp_timer_create_args_t timer_args = {
+            .callback = at_led_anim_timer_cb,
+            .name = "led_anim",
+        };
+        if (esp_timer_create(&timer_args, &led_anim_timer) != ESP_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+
+    // the timer is only started and stopped under the lock, as the flush task stops it once the animation ends
+    at_led_lock();
+    for (int i = 0; i < anim.step_num; i++) {
+        if (!led_keyframes[anim.steps[i].keyframe].rgb) {
+            at_led_unlock();
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+    esp_timer_stop(led_anim_timer);
+    anim.running = true;
+    anim.fps = fps;
+    anim.loops = loops;
+    anim.curve = curve;
+    anim.start_us = esp_timer_get_time();
+    led_anim = anim;
+    if (esp_timer_start_periodic(led_anim_timer, 1000000 / fps) != ESP_OK) {
+        led_anim.running = false;
+        at_led_unlock();
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    at_led_unlock();
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// AT+LEDANIM? reports <running>,<fps>,<loops>,<curve>,<steps>
+static uint8_t at_query_cmd_ledanim(uint8_t *cmd_name)
+{
+    uint8_t buffer[64] = {0};
+
+    at_led_lock();
+    int len = snprintf((char *)buffer, sizeof(buffer), "%s:%d,%d,%u,%d,%d\r\n", cmd_name, led_anim.running,
+                       led_anim.fps, led_anim.loops, led_anim.curve, led_anim.step_num);
+    at_led_unlock();
+    esp_at_port_write_data(buffer, len);
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// AT+LEDCFG=<format>[,<order>[,<gamma>[,<brightness>]]]
+// <format> of the pixels sent with +LED, +LEDFRAME and +LEDKEY:
+// 0 RGB332 (default), 1 RGB565, 2 RGB888, 3 GRB888.
+// <order> of the strip channels: 0 GRB (WS2812, default), 1 RGB, 2 GRBW (SK6812 RGBW).
+// <gamma> in 1/100 units (100-300, default 220) for the RGB565/RGB888/GRB888 pixels
+// received afterwards and for gamma aware fades.
+// <brightness> 0-255 scales the output, it is applied to the current frame at once.
+static uint8_t at_setup_cmd_ledcfg(uint8_t para_num)
+{
+    int32_t format = 0, order = led_order, gamma = led_gamma, brightness = led_brightness;
+    int32_t cnt = 0;
+
+    if (esp_at_get_para_as_digit(cnt++, &format) != ESP_AT_PARA_PARSE_RESULT_OK) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &order) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &gamma) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+    if (cnt < para_num) {
+        if (esp_at_get_para_as_digit(cnt++, &brightness) != ESP_AT_PARA_PARSE_RESULT_OK) {
+            return ESP_AT_RESULT_CODE_ERROR;
+        }
+    }
+    if (cnt != para_num) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    if (format < 0 || format >= LED_FORMAT_MAX || order < 0 || order >= LED_ORDER_MAX
+            || gamma < LED_GAMMA_MIN || gamma > LED_GAMMA_MAX || brightness < 0 || brightness > 255) {
+        return ESP_AT_RESULT_CODE_ERROR;
+    }
+
+    at_led_lock();
+    led_format = format;
+    led_order = order;
+    if (gamma != led_gamma || brightness != led_brightness) {
+        led_gamma = gamma;
+        led_brightness = brightness;
+        at_led_lut_update();
+    }
+    // resend the current frame with the new order and brightness
+    at_led_flush_no(led_used_no);
+    at_led_unlock();
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+static uint8_t at_query_cmd_ledcfg(uint8_t *cmd_name)
+{
+    uint8_t buffer[64] = {0};
+
+    at_led_lock();
+    int len = snprintf((char *)buffer, sizeof(buffer), "%s:%d,%d,%d,%d\r\n", cmd_name, led_format,
+                       led_order, led_gamma, led_brightness);
+    at_led_unlock();
+    esp_at_port_write_data(buffer, len);
+
+    return ESP_AT_RESULT_CODE_OK;
+}
+
+// AT+LED? reports <frames sent>,<frames dropped>,<last frame transmit time in us>
+static uint8_t at_query_cmd_led(uint8_t *cmd_name)
+{
+    uint8_t buffer[64] = {0};
+
+    at_led_lock();
+    uint32_t sent = led_frames_sent;
+    uint32_t dropped = led_frames_dropped;
+    uint32_t last_us = led_last_frame_us;
+    at_led_unlock();
+
+    int len = snprintf((char *)buffer, sizeof(buffer), "%s:%u,%u,%u\r\n", cmd_name, sent, dropped, last_us);
+    esp_at_port_write_data(buffer, len);
 
     return ESP_AT_RESULT_CODE_OK;
 }
 
 static const esp_at_cmd_struct at_led_cmd[] = {
-    {"+LED", NULL, NULL, at_setup_cmd_led, NULL},
+    {"+LED", NULL, at_query_cmd_led, at_setup_cmd_led, NULL},
+    {"+LEDFRAME", NULL, NULL, at_setup_cmd_ledframe, NULL},
+    {"+LEDKEY", NULL, NULL, at_setup_cmd_ledkey, NULL},
+    {"+LEDANIM", NULL, at_query_cmd_ledanim, at_setup_cmd_ledanim, NULL},
+    {"+LEDCFG", NULL, at_query_cmd_ledcfg, at_setup_cmd_ledcfg, NULL},
 };
 
 bool esp_at_led_cmd_regist(void)
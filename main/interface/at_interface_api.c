@@ -10,6 +10,7 @@
 #include "esp_log.h"
 #include "esp_at.h"
 #include "esp_at_core.h"
+#include "esp_at_init.h"
 #include "esp_at_interface.h"
 #ifdef CONFIG_AT_SELF_COMMAND_SUPPORT
 #include "esp_at_self_cmd.h"
@@ -23,6 +24,10 @@ static esp_at_custom_ops_struct s_interface_hooks;
 static at_intf_security_ops_t s_intf_security_ops;
 #endif
 
+// bounds of the interface task stack size tuned in the manufacturing nvs
+#define AT_INTF_TASK_STACK_SIZE_MIN         1024
+#define AT_INTF_TASK_STACK_SIZE_MAX         8192
+
 static const char *TAG = "at-intf";
 
 static int32_t at_port_read_data(uint8_t *buffer, int32_t len)
@@ -49,6 +54,14 @@ static int32_t at_port_read_data(uint8_t *buffer, int32_t len)
 
     ret = read_fn(buffer, len);
 
+#ifdef CONFIG_AT_LAZY_CMD_SET_REGISTER
+    // register the deferred command sets before the core parses their commands,
+    // the data of the passthrough mode and after the ">" prompt is skipped
+    if (ret > 0) {
+        esp_at_cmd_set_lazy_register_check(buffer, ret);
+    }
+#endif
+
 #if CONFIG_AT_RX_DATA_DEBUG
     if (ret > 0) {
         ESP_AT_LOG_BUFFER_HEXDUMP("intf-rx", buffer, at_min(ret, CONFIG_AT_RX_DATA_MAX_LEN), ESP_LOG_INFO);
@@ -64,6 +77,13 @@ static int32_t at_port_write_data(uint8_t *data, int32_t len)
         return -1;
     }
 
+#ifdef CONFIG_AT_USERWKMCU_COMMAND_SUPPORT
+    // the data will be sent once mcu is awake
+    if (at_wkmcu_write_if_waking(data, len)) {
+        return len;
+    }
+#endif
+
 #if CONFIG_AT_TX_DATA_DEBUG
     ESP_AT_LOG_BUFFER_HEXDUMP("intf-tx", data, at_min(len, CONFIG_AT_TX_DATA_MAX_LEN), ESP_LOG_INFO);
 #endif
@@ -120,6 +140,24 @@ at_read_data_fn_t at_interface_get_read_fn(void)
     return s_interface_ops.read_data;
 }
 
+BaseType_t at_interface_task_create(TaskFunction_t fn, const char *name, uint32_t stack_size, UBaseType_t priority, TaskHandle_t *handle)
+{
+    const at_sys_tune_t *tune = &at_get_mfg_params()->sys_tune;
+    BaseType_t core_id = tskNO_AFFINITY;
+
+    if (tune->intf_task_stack_size) {
+        stack_size = at_min(at_max(tune->intf_task_stack_size, AT_INTF_TASK_STACK_SIZE_MIN), AT_INTF_TASK_STACK_SIZE_MAX);
+    }
+    if (tune->intf_task_priority) {
+        priority = at_min(tune->intf_task_priority, configMAX_PRIORITIES - 1);
+    }
+    if (tune->intf_task_core_id >= 0 && tune->intf_task_core_id < portNUM_PROCESSORS) {
+        core_id = tune->intf_task_core_id;
+    }
+
+    return xTaskCreatePinnedToCore(fn, name, stack_size, NULL, priority, handle, core_id);
+}
+
 void at_interface_ops_init(esp_at_device_ops_struct *ops)
 {
     s_interface_ops.read_data = ops->read_data;
@@ -168,6 +206,10 @@ int at_interface_security_set(at_intf_security_ops_t *ops)
 
 static void at_transmit_mode_switch_cb(esp_at_status_type state)
 {
+#ifdef CONFIG_AT_LAZY_CMD_SET_REGISTER
+    esp_at_cmd_set_lazy_register_status(state);
+#endif
+
     // do some special things from the interface hook when transmit mode switch
     if (s_interface_hooks.status_callback) {
         s_interface_hooks.status_callback(state);
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_at_core.h"
 
 #ifdef CONFIG_AT_BASE_ON_UART
@@ -72,6 +74,21 @@ at_write_data_fn_t at_interface_get_write_fn(void);
 */
 at_read_data_fn_t at_interface_get_read_fn(void);
 
+/**
+ * @brief Create the task of the interface.
+ *
+ * @note The stack size, priority and core affinity can be overridden by the "sys_tune" namespace of the manufacturing nvs.
+ *
+ * @param[in] fn: task function
+ * @param[in] name: task name
+ * @param[in] stack_size: default stack size in bytes
+ * @param[in] priority: default priority
+ * @param[out] handle: the created task handle
+ *
+ * @return pdPASS on success, otherwise the error code of xTaskCreatePinnedToCore()
+*/
+BaseType_t at_interface_task_create(TaskFunction_t fn, const char *name, uint32_t stack_size, UBaseType_t priority, TaskHandle_t *handle);
+
 typedef struct {
     int (*open)(void);                                              /*!< initialize the security channel over interface */
     int32_t (*read)(uint8_t *data, int32_t size);                   /*!< read out the plain data from security channel */
@@ -198,7 +198,7 @@ static void at_sdio_init(void)
     // start sdio slave
     sdio_slave_start();
 
-    xTaskCreate(at_sdio_task, "at_sdio_task", 4096, NULL, 2, &s_task_handle);
+    at_interface_task_create(at_sdio_task, "at_sdio_task", 4096, 2, &s_task_handle);
 }
 
 void at_interface_init(void)
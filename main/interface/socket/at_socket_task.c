@@ -214,7 +214,7 @@ static void at_socket_init(void)
     ESP_ERROR_CHECK(esp_netif_get_ip_info(ap_if, &ip));
     ESP_AT_LOGI(TAG, "softap: (%s) started, listen on (" IPSTR ":%d)", config.ap.ssid, IP2STR(&ip.ip), CONFIG_AT_SOCKET_PORT);
 
-    xTaskCreate(&socket_task, "socket_task", 4096, NULL, 5, &s_task_handle);
+    at_interface_task_create(socket_task, "socket_task", 4096, 5, &s_task_handle);
 }
 
 void at_interface_init(void)
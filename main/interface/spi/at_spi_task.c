@@ -333,7 +333,7 @@ static void at_spi_init(void)
     init_slave_hd();
 
     // init spi slave task
-    xTaskCreate(at_spi_task, "at_spi_task", 4096, NULL, 10, &s_task_handle);
+    at_interface_task_create(at_spi_task, "at_spi_task", 4096, 10, &s_task_handle);
 }
 
 static void at_spi_sleep_before_cb(at_sleep_mode_t mode)
@@ -206,7 +206,7 @@ static void at_uart_init(void)
                 g_at_cmd_port, g_uart_port_pin.tx_pin, g_uart_port_pin.rx_pin,
                 g_uart_port_pin.cts_pin, g_uart_port_pin.rts_pin, config.baud_rate);
 
-    xTaskCreate(at_uart_task, "uTask", 1024, NULL, 1, &s_task_handle);
+    at_interface_task_create(at_uart_task, "uTask", 1024, 1, &s_task_handle);
 }
 
 void at_uart_transmit_mode_switch_cb(esp_at_status_type status)
@@ -42,6 +42,22 @@ mfg_directory = 'mfg_nvs'
 mfg_csv_filename = 'mfg_nvs.csv'
 mfg_bin_filename = 'mfg_nvs.bin'
 
+# system tuning parameters in the "sys_tune" namespace of manufacturing nvs: key -> (encoding, min, max)
+# the bounds should be the same as the ones the firmware clamps to, except that the ones of netconn_max
+# and intf_core depend on the build, so they are only advisory here and narrowed by --sdkconfig;
+# the firmware still clamps netconn_max to CONFIG_AT_SOCKET_MAX_CONN_NUM and ignores an invalid core
+sys_tune_namespace = 'sys_tune'
+sys_tune_params = {
+    'proc_stack': ('u32', 2048, 16384),
+    'sock_stack': ('u32', 2048, 16384),
+    'netconn_max': ('u32', 1, 255),
+    'http_tx_buf': ('u32', 512, 16384),
+    'http_rx_buf': ('u32', 512, 16384),
+    'intf_stack': ('u32', 1024, 8192),
+    'intf_prio': ('u8', 1, 24),
+    'intf_core': ('i8', -1, 1),
+}
+
 def ESP_LOGI(x):
     print('\033[32m{}\033[0m'.format(x))
 
@@ -52,6 +68,52 @@ def arg_auto_int(x):
     r = int(x, 0)
     return r if r >= 0 else -1
 
+def arg_sys_tune(x):
+    if '=' not in x:
+        raise argparse.ArgumentTypeError('{} should be in the format of <key>=<value>'.format(x))
+    key, value = x.split('=', 1)
+    key = key.strip()
+    if key not in sys_tune_params:
+        raise argparse.ArgumentTypeError('unknown sys_tune key: {}, valid keys: {}'.format(key, ', '.join(sys_tune_params)))
+    try:
+        value = int(value, 0)
+    except ValueError:
+        raise argparse.ArgumentTypeError('invalid value of {}: {}'.format(key, value))
+    _, vmin, vmax = sys_tune_params[key]
+    if value < vmin or value > vmax:
+        raise argparse.ArgumentTypeError('{} should be in range [{}, {}]'.format(key, vmin, vmax))
+    return (key, value)
+
+def sys_tune_sdkconfig_bounds(sdkconfig):
+    """
+    Return the bounds of the sys_tune parameters which depend on the build: key -> (min, max)
+    """
+    options = {}
+    with open(sdkconfig, 'r') as fp:
+        for line in fp:
+            line = line.strip()
+            if line.startswith('CONFIG_') and '=' in line:
+                key, value = line.split('=', 1)
+                options[key] = value.strip('"')
+            elif line.startswith('# CONFIG_') and line.endswith(' is not set'):
+                options[line[2:-len(' is not set')]] = 'n'
+
+    bounds = {}
+    if 'CONFIG_AT_SOCKET_MAX_CONN_NUM' in options:
+        bounds['netconn_max'] = (1, int(options['CONFIG_AT_SOCKET_MAX_CONN_NUM'], 0))
+    if 'CONFIG_FREERTOS_NUMBER_OF_CORES' in options:
+        bounds['intf_core'] = (-1, int(options['CONFIG_FREERTOS_NUMBER_OF_CORES'], 0) - 1)
+    elif 'CONFIG_FREERTOS_UNICORE' in options:
+        bounds['intf_core'] = (-1, 0 if options['CONFIG_FREERTOS_UNICORE'] == 'y' else 1)
+    return bounds
+
+def at_check_sys_tune(tune, bounds):
+    for key, value in tune or []:
+        if key in bounds:
+            vmin, vmax = bounds[key]
+            if value < vmin or value > vmax:
+                raise ValueError('{} should be in range [{}, {}] for this build'.format(key, vmin, vmax))
+
 def at_read_records(format, f):
     record_struct = Struct(format)
     chunks = f.read(record_struct.size)
@@ -84,6 +146,13 @@ def modify_bin(esp, args):
         ESP_LOGE('Invalid file size: {}'.format(fsize))
         sys.exit(2)
 
+    if args.sys_tune and args.sdkconfig:
+        try:
+            at_check_sys_tune(args.sys_tune, sys_tune_sdkconfig_bounds(args.sdkconfig))
+        except (IOError, ValueError) as e:
+            ESP_LOGE('Invalid sys_tune parameter: {}'.format(e))
+            sys.exit(2)
+
     copyfile(args.input, args.output)
 
     with open(args.input, 'rb') as fp:
@@ -1085,6 +1154,40 @@ def at_update_mfg_parameters(args, data):
 
     return data
 
+def at_update_sys_tune(tune, data):
+    if not tune:
+        return data
+
+    # take out the existing sys_tune namespace, and merge the new values into it
+    values = {}
+    others = []     # the entries of the namespace at.py does not know, kept as they are
+    lines = []
+    in_sys_tune = False
+    for line in data.split('\n'):
+        fields = line.strip().split(',')
+        if len(fields) >= 2 and fields[1] == 'namespace':
+            in_sys_tune = (fields[0] == sys_tune_namespace)
+            if in_sys_tune:
+                continue
+        elif in_sys_tune and len(fields) == 4 and fields[0] in sys_tune_params:
+            values[fields[0]] = int(fields[3], 0)
+            continue
+        elif in_sys_tune and line.strip():
+            others.append(line)
+            continue
+        lines.append(line)
+    values.update(dict(tune))
+
+    while lines and lines[-1].strip() == '':
+        lines.pop()
+    lines.append(sys_tune_namespace + ',namespace,,')
+    for key, value in values.items():
+        lines.append('{},data,{},{}'.format(key, sys_tune_params[key][0], value))
+    lines.extend(others)
+    ESP_LOGI('sys_tune: {}'.format(values))
+
+    return '\n'.join(lines) + '\n'
+
 def modify_param_bin_in_nvs(esp, args):
     """
     A typic format of esp-at parameter binary is in nvs partition, and these parameters support to configure:
@@ -1134,6 +1237,7 @@ def modify_param_bin_in_nvs(esp, args):
     with open(mfg_nvs_csv, 'r+') as fp:
         data = fp.read()
         data = at_update_mfg_parameters(args, data)
+        data = at_update_sys_tune(args.sys_tune, data)
         fp.seek(0)
         fp.truncate(0)
         fp.write(data)
@@ -1391,6 +1495,17 @@ def main(argv=None, esp=None):
             help='Specify the nth configuration of GATTS to update. This will update the index={} line of esp-at/components/customized_partitions/raw_data/ble_data/gatts_data.csv file'.format(i),
             type=str)
 
+    parser_modify_bin.add_argument('--sys_tune', '-st',
+        help='Set a system tuning parameter (task stack sizes, priorities, buffer sizes) in the sys_tune namespace of manufacturing nvs, '
+             'in the format of <key>=<value>, can be used multiple times. Valid keys: {}'.format(', '.join(sys_tune_params)),
+        action='append',
+        type=arg_sys_tune)
+
+    parser_modify_bin.add_argument('--sdkconfig', '-sdk',
+        help='The sdkconfig file the input firmware is built with, to check the sys_tune parameters which depend on the build (netconn_max, intf_core) against it.',
+        metavar='filename',
+        type=str)
+
     parser_modify_bin.add_argument('--parameter_offset', '-os',
         help='Offset of parameter partition in AT firmware. If this parameter is set, the input file will be parsed directly according to the parameter instead of automatically matching the parameter partition header.',
         type=arg_auto_int)
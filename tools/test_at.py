@@ -0,0 +1,110 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""
+Tests of the sys_tune parameters of at.py
+
+    python -m unittest discover -s tools -p "test_*.py"
+"""
+
+import argparse
+import os
+import tempfile
+import unittest
+
+import at
+
+
+class TestArgSysTune(unittest.TestCase):
+    def test_valid(self):
+        self.assertEqual(at.arg_sys_tune('sock_stack=4096'), ('sock_stack', 4096))
+        self.assertEqual(at.arg_sys_tune(' intf_prio =0x5'), ('intf_prio', 5))
+        self.assertEqual(at.arg_sys_tune('intf_core=-1'), ('intf_core', -1))
+        self.assertEqual(at.arg_sys_tune('proc_stack=16384'), ('proc_stack', 16384))
+
+    def test_invalid(self):
+        for arg in ['sock_stack', 'no_such_key=1', 'sock_stack=4k', 'sock_stack=',
+                    'sock_stack=2047', 'proc_stack=16385', 'intf_core=-2', 'netconn_max=0']:
+            with self.assertRaises(argparse.ArgumentTypeError, msg=arg):
+                at.arg_sys_tune(arg)
+
+    def test_advisory_bounds(self):
+        # the ones depending on the build are only checked against the widest range
+        self.assertEqual(at.arg_sys_tune('netconn_max=32'), ('netconn_max', 32))
+        self.assertEqual(at.arg_sys_tune('intf_core=1'), ('intf_core', 1))
+
+
+class TestSdkconfigBounds(unittest.TestCase):
+    def bounds(self, content):
+        with tempfile.NamedTemporaryFile('w', suffix='sdkconfig', delete=False) as fp:
+            fp.write(content)
+        try:
+            return at.sys_tune_sdkconfig_bounds(fp.name)
+        finally:
+            os.remove(fp.name)
+
+    def test_single_core(self):
+        bounds = self.bounds('CONFIG_AT_SOCKET_MAX_CONN_NUM=5\nCONFIG_FREERTOS_UNICORE=y\n')
+        self.assertEqual(bounds, {'netconn_max': (1, 5), 'intf_core': (-1, 0)})
+        at.at_check_sys_tune([('netconn_max', 5), ('intf_core', 0), ('sock_stack', 4096)], bounds)
+        with self.assertRaises(ValueError):
+            at.at_check_sys_tune([('netconn_max', 6)], bounds)
+        with self.assertRaises(ValueError):
+            at.at_check_sys_tune([('intf_core', 1)], bounds)
+
+    def test_dual_core(self):
+        self.assertEqual(self.bounds('# CONFIG_FREERTOS_UNICORE is not set\n'), {'intf_core': (-1, 1)})
+        self.assertEqual(self.bounds('CONFIG_FREERTOS_NUMBER_OF_CORES=2\nCONFIG_FREERTOS_UNICORE=n\n'), {'intf_core': (-1, 1)})
+
+    def test_unknown(self):
+        # without the options, the advisory bounds are kept
+        bounds = self.bounds('# CONFIG_AT_NET_COMMAND_SUPPORT is not set\n')
+        self.assertEqual(bounds, {})
+        at.at_check_sys_tune([('netconn_max', 32)], bounds)
+        at.at_check_sys_tune(None, bounds)
+
+
+class TestUpdateSysTune(unittest.TestCase):
+    CSV = ('key,type,encoding,value\n'
+           'factory_param,namespace,,\n'
+           'module_name,data,string,"MINI-1"\n'
+           'uart_port,data,i32,1\n')
+
+    def test_no_tune(self):
+        self.assertEqual(at.at_update_sys_tune(None, self.CSV), self.CSV)
+        self.assertEqual(at.at_update_sys_tune([], self.CSV), self.CSV)
+
+    def test_new_namespace(self):
+        data = at.at_update_sys_tune([('sock_stack', 4096), ('intf_core', -1)], self.CSV + '\n\n')
+        self.assertEqual(data, self.CSV +
+                         'sys_tune,namespace,,\n'
+                         'sock_stack,data,u32,4096\n'
+                         'intf_core,data,i8,-1\n')
+
+    def test_merge_namespace(self):
+        # the namespace is moved to the end, the existing values are kept unless they are given again,
+        # and the keys at.py does not know stay in the namespace
+        csv = (self.CSV +
+               'sys_tune,namespace,,\n'
+               'sock_stack,data,u32,3072\n'
+               'intf_prio,data,u8,0x5\n'
+               'removed_key,data,u32,1\n'
+               'ble_data,namespace,,\n'
+               'cfg0,data,string,"x"\n')
+        data = at.at_update_sys_tune([('sock_stack', 4096), ('proc_stack', 8192)], csv)
+        self.assertEqual(data, self.CSV +
+                         'ble_data,namespace,,\n'
+                         'cfg0,data,string,"x"\n'
+                         'sys_tune,namespace,,\n'
+                         'sock_stack,data,u32,4096\n'
+                         'intf_prio,data,u8,5\n'
+                         'proc_stack,data,u32,8192\n'
+                         'removed_key,data,u32,1\n')
+
+    def test_repeated_key(self):
+        # the last one of a key given several times wins
+        data = at.at_update_sys_tune([('intf_prio', 3), ('intf_prio', 7)], self.CSV)
+        self.assertTrue(data.endswith('sys_tune,namespace,,\nintf_prio,data,u8,7\n'))
+
+
+if __name__ == '__main__':
+    unittest.main()